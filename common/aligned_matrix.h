@@ -0,0 +1,160 @@
+/* Выровненная матрица на больших страницах (используется в lab2 и lab3) - основные моменты:
+    Хранение:
+        Матрица - rowsc строк по colsc элементов. Строка занимает stride элементов: длина дополняется
+        до кратной 64 байтам (каждая строка начинается с границы кэш-линии, поэтому в ядрах можно
+        использовать выровненные _mm256_load_pd/_mm256_store_pd), а если stride в байтах кратен 4 КиБ,
+        добавляется ещё одна кэш-линия - иначе соседние строки попадают в одни и те же наборы кэша.
+        В lab3 матрицы хранятся по столбцам, там "строка" контейнера - столбец матрицы.
+
+    Выделение памяти:
+        Память берётся через mmap без инициализации: страницы выделяются физически при первом
+        обращении (first touch), поэтому нет лишнего прохода с нулями, как у std::vector.
+        * page_policy::huge      - MAP_HUGETLB (2 МБ), при отсутствии зарезервированных страниц -
+                                   переход к transparent; используется по умолчанию;
+        * page_policy::transparent - обычная память, выровненная на 2 МБ, с madvise(MADV_HUGEPAGE);
+        * page_policy::normal    - обычные страницы 4 КБ.
+        Большие страницы уменьшают количество промахов TLB: 8 ГиБ - это 2 млн страниц по 4 КБ
+        и всего 4096 по 2 МБ. */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <sys/mman.h>
+
+// Способ выделения страниц
+enum class page_policy
+{
+    normal,
+    transparent,
+    huge
+};
+
+template <class T>
+class AlignedMatrix
+{
+public:
+    static constexpr std::size_t alignment = 64;             // Выравнивание строк (кэш-линия)
+    static constexpr std::size_t huge_page = std::size_t(2) << 20; // Размер большой страницы
+
+    // Матрица без инициализации; при нехватке памяти бросает std::bad_alloc
+    AlignedMatrix(std::size_t colsc, std::size_t rowsc, page_policy policy = page_policy::huge)
+        : cols_(colsc), rows_(rowsc), stride_(paddedStride(colsc))
+    {
+        bytes_ = (rows_ * stride_ * sizeof(T) + huge_page - 1) / huge_page * huge_page;
+
+        if (policy == page_policy::huge)
+        {
+            void* memory = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                                -1, 0);
+            if (memory != MAP_FAILED)
+            {
+                data_ = static_cast<T*>(memory);
+                huge_ = true;
+                return;
+            }
+            policy = page_policy::transparent; // Большие страницы не зарезервированы в системе
+        }
+
+        // Лишние 2 МБ позволяют выровнять начало на границу большой страницы, остаток отдаётся обратно
+        const std::size_t extra = policy == page_policy::transparent ? huge_page : 0;
+        void* memory = mmap(nullptr, bytes_ + extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED)
+            throw std::bad_alloc();
+
+        char* raw = static_cast<char*>(memory);
+        char* aligned = raw;
+        if (extra)
+        {
+            aligned = reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(raw) + huge_page - 1) / huge_page *
+                                              huge_page);
+            if (aligned != raw)
+                munmap(raw, aligned - raw);
+            if (aligned + bytes_ != raw + bytes_ + extra)
+                munmap(aligned + bytes_, raw + extra - aligned);
+            madvise(aligned, bytes_, MADV_HUGEPAGE);
+        }
+        data_ = reinterpret_cast<T*>(aligned);
+    }
+
+    ~AlignedMatrix()
+    {
+        if (data_)
+            munmap(data_, bytes_);
+    }
+
+    AlignedMatrix(const AlignedMatrix&) = delete;
+    AlignedMatrix& operator=(const AlignedMatrix&) = delete;
+
+    AlignedMatrix(AlignedMatrix&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), bytes_(other.bytes_), cols_(other.cols_), rows_(other.rows_),
+          stride_(other.stride_), huge_(other.huge_)
+    {
+    }
+
+    std::size_t cols() const { return cols_; }
+    std::size_t rows() const { return rows_; }
+    std::size_t stride() const { return stride_; } // Расстояние между началами строк в элементах
+    bool hugePages() const { return huge_; }       // Выделена ли память через MAP_HUGETLB
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    T* row(std::size_t r) { return data_ + r * stride_; }
+    const T* row(std::size_t r) const { return data_ + r * stride_; }
+
+    T& operator()(std::size_t r, std::size_t c) { return data_[r * stride_ + c]; }
+    const T& operator()(std::size_t r, std::size_t c) const { return data_[r * stride_ + c]; }
+
+    // Заполнение значением value (дополнение строк не трогается)
+    void fill(T value)
+    {
+        for (std::size_t r = 0; r < rows_; r++)
+        {
+            T* p = row(r);
+            for (std::size_t c = 0; c < cols_; c++)
+            {
+                p[c] = value;
+            }
+        }
+    }
+
+    // Копирование из плотной матрицы rowsc x colsc без дополнения строк
+    void assign(const T* source)
+    {
+        for (std::size_t r = 0; r < rows_; r++)
+        {
+            std::memcpy(row(r), source + r * cols_, cols_ * sizeof(T));
+        }
+    }
+
+    // Поэлементное сравнение без учёта дополнения строк
+    bool operator==(const AlignedMatrix& other) const
+    {
+        if (cols_ != other.cols_ || rows_ != other.rows_)
+            return false;
+        for (std::size_t r = 0; r < rows_; r++)
+        {
+            if (std::memcmp(row(r), other.row(r), cols_ * sizeof(T)) != 0)
+                return false;
+        }
+        return true;
+    }
+
+    // Длина строки с дополнением: кратна 64 байтам и не кратна 4 КиБ
+    static std::size_t paddedStride(std::size_t colsc)
+    {
+        const std::size_t perLine = alignment / sizeof(T);
+        std::size_t stride = (colsc + perLine - 1) / perLine * perLine;
+        if (stride * sizeof(T) % 4096 == 0)
+            stride += perLine;
+        return stride;
+    }
+
+private:
+    T* data_ = nullptr;
+    std::size_t bytes_ = 0; // Размер отображения (кратен 2 МБ)
+    std::size_t cols_, rows_, stride_;
+    bool huge_ = false;
+};
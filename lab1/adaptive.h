@@ -0,0 +1,197 @@
+/* Адаптивное интегрирование по правилу Гаусса-Кронрода G7K15 - основные моменты:
+    Правило на отрезке:
+        15 узлов Кронрода дают значение интеграла, 7 из них (узлы Гаусса) - грубое значение.
+        Модуль разности |K15 - G7| используется как оценка погрешности на отрезке.
+
+    Адаптивное деление:
+        Отрезок принимается, если его погрешность не больше доли допуска, пропорциональной его длине.
+        Иначе он делится пополам и обе половины ставятся в очередь.
+        Деление ограничено глубиной max_depth и общим числом отрезков max_segments (limit в QUADPACK):
+        после исчерпания лимита оставшиеся отрезки принимаются со своими оценками погрешности.
+
+    Распределение работы (work stealing):
+        У каждого потока своя очередь отрезков. Поток берёт работу с конца своей очереди,
+        а когда она пуста - крадёт самый крупный (самый старый) отрезок из начала чужой очереди.
+        Счётчик незавершённых отрезков показывает, когда работа закончилась у всех потоков.
+
+    Результат содержит значение, оценку погрешности и число вычислений функции,
+    чтобы сравнивать стоимость с integrateParallel (N вычислений). */
+
+#pragma once
+#include <omp.h>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Результат адаптивного интегрирования
+struct adaptive_result
+{
+    double value;            // Значение интеграла
+    double error;            // Оценка погрешности (сумма |K15 - G7| по принятым отрезкам)
+    std::size_t evaluations; // Количество вычислений функции
+    std::size_t intervals;   // Количество принятых отрезков
+};
+
+// Узлы и веса правила Гаусса-Кронрода G7K15 на [-1, 1] (симметричны, хранится половина)
+namespace gk15
+{
+    constexpr double xgk[8] = {
+        0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+        0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+        0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+        0.207784955007898467600689403773245, 0.000000000000000000000000000000000};
+    constexpr double wgk[8] = {
+        0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+        0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+        0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+        0.204432940075298892414161999234649, 0.209482141084727828012999174891714};
+    // Веса Гаусса для узлов xgk[1], xgk[3], xgk[5], xgk[7]
+    constexpr double wg[4] = {
+        0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+        0.381830050505118944950369775488975, 0.417959183673469387755102040816327};
+}
+
+// Отрезок, ожидающий обработки
+struct gk_segment
+{
+    double a, b;
+    unsigned depth; // Глубина деления
+};
+
+// Правило G7K15 на отрезке [a, b]: возвращает значение K15 и записывает |K15 - G7| в error
+template <class F>
+double gaussKronrod15(const F& f, double a, double b, double& error)
+{
+    const double center = 0.5 * (a + b);
+    const double half = 0.5 * (b - a);
+
+    const double fc = f(center);
+    double kronrod = fc * gk15::wgk[7];
+    double gauss = fc * gk15::wg[3];
+
+    for (int j = 0; j < 7; j++)
+    {
+        const double dx = half * gk15::xgk[j];
+        const double fsum = f(center - dx) + f(center + dx);
+        kronrod += gk15::wgk[j] * fsum;
+        if (j % 2 == 1) // Нечётные узлы Кронрода совпадают с узлами Гаусса
+        {
+            gauss += gk15::wg[j / 2] * fsum;
+        }
+    }
+
+    error = std::abs((kronrod - gauss) * half);
+    return kronrod * half;
+}
+
+// Очередь отрезков одного потока вместе с его частичными результатами
+struct alignas(64) gk_worker
+{
+    std::mutex lock;
+    std::deque<gk_segment> segments;
+    double value = 0;
+    double error = 0;
+    std::size_t evaluations = 0;
+    std::size_t intervals = 0;
+};
+
+// Адаптивное параллельное интегрирование f на [a, b] с допуском tolerance;
+// при отрицательном или NaN допуске бросает std::invalid_argument
+template <class F>
+adaptive_result integrateAdaptive(const F& f, double a, double b, double tolerance, unsigned max_depth = 50,
+                                  std::size_t max_segments = std::size_t(1) << 20)
+{
+    if (!(tolerance >= 0))
+        throw std::invalid_argument("integrateAdaptive: tolerance must be non-negative");
+    if (a == b)
+        return adaptive_result{0, 0, 0, 0};
+
+    const unsigned T = omp_get_max_threads();
+    std::vector<gk_worker> workers(T);
+    std::atomic<std::size_t> pending = 1;  // Отрезки в очередях и в обработке
+    std::atomic<std::size_t> segments = 1; // Всего отрезков с начала (не больше max_segments)
+    const double length = std::abs(b - a);
+
+    workers[0].segments.push_back(gk_segment{a, b, 0});
+
+#pragma omp parallel num_threads(T)
+    {
+        const unsigned t = omp_get_thread_num();
+        gk_worker& self = workers[t];
+
+        while (pending.load(std::memory_order_acquire) != 0)
+        {
+            gk_segment segment;
+            bool found = false;
+
+            // Сначала своя очередь (с конца - последние, самые мелкие отрезки)
+            {
+                std::lock_guard<std::mutex> guard(self.lock);
+                if (!self.segments.empty())
+                {
+                    segment = self.segments.back();
+                    self.segments.pop_back();
+                    found = true;
+                }
+            }
+
+            // Затем кража из начала чужих очередей
+            for (unsigned k = 1; !found && k < T; k++)
+            {
+                gk_worker& victim = workers[(t + k) % T];
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if (!victim.segments.empty())
+                {
+                    segment = victim.segments.front();
+                    victim.segments.pop_front();
+                    found = true;
+                }
+            }
+
+            if (!found)
+            {
+                std::this_thread::yield(); // Работа есть только у других потоков, ждём
+                continue;
+            }
+
+            double error;
+            const double value = gaussKronrod15(f, segment.a, segment.b, error);
+            self.evaluations += 15;
+
+            // Допуск делится между отрезками пропорционально длине
+            const double allowed = tolerance * std::abs(segment.b - segment.a) / length;
+            if (error <= allowed || segment.depth >= max_depth ||
+                segments.fetch_add(1, std::memory_order_relaxed) >= max_segments)
+            {
+                self.value += value;
+                self.error += error;
+                self.intervals++;
+                pending.fetch_sub(1, std::memory_order_release);
+            }
+            else
+            {
+                const double middle = 0.5 * (segment.a + segment.b);
+                pending.fetch_add(1, std::memory_order_relaxed); // Был один отрезок, стало два
+                std::lock_guard<std::mutex> guard(self.lock);
+                self.segments.push_back(gk_segment{segment.a, middle, segment.depth + 1});
+                self.segments.push_back(gk_segment{middle, segment.b, segment.depth + 1});
+            }
+        }
+    }
+
+    // Суммирование частичных результатов в фиксированном порядке потоков
+    adaptive_result result{0, 0, 0, 0};
+    for (const gk_worker& w : workers)
+    {
+        result.value += w.value;
+        result.error += w.error;
+        result.evaluations += w.evaluations;
+        result.intervals += w.intervals;
+    }
+    return result;
+}
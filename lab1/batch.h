@@ -0,0 +1,43 @@
+/* Пакетное интегрирование - много небольших интегралов за один вызов:
+    Каждое задание содержит свою функцию (функтор с параметрами), границы и количество разбиений.
+    Задания распределяются между потоками одной параллельной секцией OpenMP с динамическим
+    планированием порциями по chunk заданий, поэтому потоки не простаивают при разной длине заданий
+    и не платят за отдельную параллельную секцию на каждый интеграл.
+    Каждое задание считается одним потоком тем же SIMD-ядром sumPoints, что и integrate. */
+
+#pragma once
+#include <omp.h>
+#include <cstddef>
+#include <vector>
+#include "integrate.h"
+
+// Одно задание пакетного интегрирования
+template <class F>
+struct integral_job
+{
+    F f;           // Функция (может хранить свои параметры)
+    double a, b;   // Границы интегрирования
+    std::size_t n; // Количество разбиений
+};
+
+// Интегрирует все задания и возвращает результаты в том же порядке
+template <class F>
+std::vector<double> integrateBatch(const std::vector<integral_job<F>>& jobs, std::size_t chunk = 64)
+{
+    std::vector<double> results(jobs.size());
+
+#pragma omp parallel for schedule(dynamic, chunk)
+    for (std::size_t i = 0; i < jobs.size(); i++)
+    {
+        const integral_job<F>& job = jobs[i];
+        if (job.n == 0) // Нет разбиений - нет и вклада (иначе шаг бесконечен, а сумма пуста)
+        {
+            results[i] = 0;
+            continue;
+        }
+        double dx = (job.b - job.a) / job.n; // Шаг разбиения
+        results[i] = dx * sumPoints(job.f, job.a, dx, 0, job.n);
+    }
+
+    return results;
+}
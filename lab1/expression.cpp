@@ -0,0 +1,356 @@
+/* Разбор строки выражения и генерация байткода для CompiledExpression.
+    * Рекурсивный спуск строит дерево, константные поддеревья сразу сворачиваются в числа.
+    * Целые степени (x^2, x^3, ...) раскрываются в умножения возведением в квадрат.
+    * Регистры выделяются стеком: результат поддерева кладётся в регистр с номером его глубины. */
+
+#include "expression.h"
+#include <cctype>
+#include <cstdlib>
+#include <numbers>
+#include <sstream>
+#include <stdexcept>
+
+double applyOperation(expr_op op, double a, double b)
+{
+    switch (op)
+    {
+    case expr_op::neg: return -a;
+    case expr_op::add: return a + b;
+    case expr_op::sub: return a - b;
+    case expr_op::mul: return a * b;
+    case expr_op::div: return a / b;
+    case expr_op::pow: return std::pow(a, b);
+    case expr_op::sqrt: return std::sqrt(a);
+    case expr_op::abs: return std::abs(a);
+    case expr_op::sin: return std::sin(a);
+    case expr_op::cos: return std::cos(a);
+    case expr_op::tan: return std::tan(a);
+    case expr_op::exp: return std::exp(a);
+    case expr_op::log: return std::log(a);
+    default: return a;
+    }
+}
+
+namespace
+{
+    // Узел дерева выражения
+    struct expr_node
+    {
+        expr_op op;
+        double value = 0;      // Для констант
+        int left = -1, right = -1;
+    };
+
+    // Функции, доступные в выражении
+    struct function_name
+    {
+        const char* name;
+        expr_op op;
+    };
+
+    const function_name functions[] = {
+        {"sqrt", expr_op::sqrt}, {"abs", expr_op::abs}, {"sin", expr_op::sin}, {"cos", expr_op::cos},
+        {"tan", expr_op::tan},   {"exp", expr_op::exp}, {"log", expr_op::log}};
+
+    bool isUnary(expr_op op)
+    {
+        return op == expr_op::neg || op >= expr_op::sqrt;
+    }
+
+    // Рекурсивный спуск:
+    //   expr    := term (('+' | '-') term)*
+    //   term    := unary (('*' | '/') unary)*
+    //   unary   := '-' unary | power
+    //   power   := primary ('^' unary)?
+    //   primary := число | x | pi | e | функция '(' expr ')' | '(' expr ')'
+    class Parser
+    {
+    public:
+        explicit Parser(const std::string& text) : text_(text) {}
+
+        std::vector<expr_node> parse(int& root)
+        {
+            root = parseExpr();
+            skipSpaces();
+            if (pos_ != text_.size())
+                fail("unexpected symbol");
+            return std::move(nodes_);
+        }
+
+    private:
+        [[noreturn]] void fail(const char* message) const
+        {
+            std::ostringstream error;
+            error << "Expression error at position " << pos_ << ": " << message;
+            throw std::invalid_argument(error.str());
+        }
+
+        void skipSpaces()
+        {
+            while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_])))
+                pos_++;
+        }
+
+        bool accept(char c)
+        {
+            skipSpaces();
+            if (pos_ < text_.size() && text_[pos_] == c)
+            {
+                pos_++;
+                return true;
+            }
+            return false;
+        }
+
+        int constant(double value)
+        {
+            nodes_.push_back(expr_node{expr_op::constant, value});
+            return static_cast<int>(nodes_.size() - 1);
+        }
+
+        bool isConstant(int node) const { return nodes_[node].op == expr_op::constant; }
+
+        // Новый узел; если все операнды - константы, он сразу сворачивается в число
+        int node(expr_op op, int left, int right = -1)
+        {
+            if (isConstant(left) && (right < 0 || isConstant(right)))
+                return constant(applyOperation(op, nodes_[left].value, right < 0 ? 0 : nodes_[right].value));
+            nodes_.push_back(expr_node{op, 0, left, right});
+            return static_cast<int>(nodes_.size() - 1);
+        }
+
+        int parseExpr()
+        {
+            int left = parseTerm();
+            while (true)
+            {
+                if (accept('+')) left = node(expr_op::add, left, parseTerm());
+                else if (accept('-')) left = node(expr_op::sub, left, parseTerm());
+                else return left;
+            }
+        }
+
+        int parseTerm()
+        {
+            int left = parseUnary();
+            while (true)
+            {
+                if (accept('*')) left = node(expr_op::mul, left, parseUnary());
+                else if (accept('/')) left = node(expr_op::div, left, parseUnary());
+                else return left;
+            }
+        }
+
+        int parseUnary()
+        {
+            if (accept('-'))
+                return node(expr_op::neg, parseUnary());
+            if (accept('+'))
+                return parseUnary();
+            return parsePower();
+        }
+
+        int parsePower()
+        {
+            int base = parsePrimary();
+            if (accept('^'))
+                return node(expr_op::pow, base, parseUnary());
+            return base;
+        }
+
+        int parsePrimary()
+        {
+            skipSpaces();
+            if (accept('('))
+            {
+                int inner = parseExpr();
+                if (!accept(')'))
+                    fail("')' expected");
+                return inner;
+            }
+
+            if (pos_ < text_.size() && (std::isdigit(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '.'))
+            {
+                const char* begin = text_.c_str() + pos_;
+                char* end = nullptr;
+                double value = std::strtod(begin, &end);
+                pos_ += end - begin;
+                return constant(value);
+            }
+
+            std::size_t start = pos_;
+            while (pos_ < text_.size() && std::isalpha(static_cast<unsigned char>(text_[pos_])))
+                pos_++;
+            const std::string name = text_.substr(start, pos_ - start);
+
+            if (name == "x")
+            {
+                nodes_.push_back(expr_node{expr_op::x});
+                return static_cast<int>(nodes_.size() - 1);
+            }
+            if (name == "pi")
+                return constant(std::numbers::pi);
+            if (name == "e")
+                return constant(std::numbers::e);
+
+            for (const function_name& function : functions)
+            {
+                if (name == function.name)
+                {
+                    if (!accept('('))
+                        fail("'(' expected after function name");
+                    int argument = parseExpr();
+                    if (!accept(')'))
+                        fail("')' expected");
+                    return node(function.op, argument);
+                }
+            }
+
+            pos_ = start;
+            fail(name.empty() ? "operand expected" : "unknown name");
+        }
+
+        const std::string& text_;
+        std::size_t pos_ = 0;
+        std::vector<expr_node> nodes_;
+    };
+
+    // Генерация байткода по дереву
+    class CodeGenerator
+    {
+    public:
+        CodeGenerator(const std::vector<expr_node>& nodes, std::vector<expr_instr>& code, std::vector<double>& constants)
+            : nodes_(nodes), code_(code), constants_(constants) {}
+
+        // Результат поддерева node помещается в регистр reg, регистры выше reg - временные
+        void generate(int node, unsigned reg)
+        {
+            use(reg);
+            const expr_node& n = nodes_[node];
+
+            switch (n.op)
+            {
+            case expr_op::x:
+                emit(expr_op::x, reg);
+                return;
+
+            case expr_op::constant:
+                if (constants_.size() > UINT8_MAX)
+                    throw std::invalid_argument("Expression error: too many constants");
+                constants_.push_back(n.value);
+                emit(expr_op::constant, reg, constants_.size() - 1);
+                return;
+
+            case expr_op::pow:
+                if (isSmallInteger(n.right))
+                {
+                    generatePower(n.left, static_cast<unsigned>(nodes_[n.right].value), reg);
+                    return;
+                }
+                break;
+
+            default:
+                break;
+            }
+
+            generate(n.left, reg);
+            if (isUnary(n.op))
+            {
+                emit(n.op, reg, reg, reg);
+            }
+            else
+            {
+                generate(n.right, reg + 1);
+                emit(n.op, reg, reg, reg + 1);
+            }
+        }
+
+        unsigned registers() const { return registers_; }
+
+    private:
+        bool isSmallInteger(int node) const
+        {
+            const expr_node& n = nodes_[node];
+            return n.op == expr_op::constant && n.value >= 1 && n.value <= 64 && n.value == std::floor(n.value);
+        }
+
+        // base ^ power возведением в квадрат: reg - текущий квадрат, reg + 1 - накопленное произведение
+        void generatePower(int base, unsigned power, unsigned reg)
+        {
+            generate(base, reg);
+
+            // Степень двойки - только возведения в квадрат, без накопителя
+            if ((power & (power - 1)) == 0)
+            {
+                for (; power > 1; power >>= 1)
+                    emit(expr_op::mul, reg, reg, reg);
+                return;
+            }
+
+            use(reg + 1);
+            bool first = true;
+            while (true)
+            {
+                if (power & 1)
+                {
+                    if (first) emit(expr_op::copy, reg + 1, reg);
+                    else emit(expr_op::mul, reg + 1, reg + 1, reg);
+                    first = false;
+                }
+                power >>= 1;
+                if (!power)
+                    break;
+                emit(expr_op::mul, reg, reg, reg);
+            }
+            emit(expr_op::copy, reg, reg + 1);
+        }
+
+        void use(unsigned reg)
+        {
+            if (reg >= expression_max_registers)
+                throw std::invalid_argument("Expression error: expression is too deep");
+            registers_ = std::max(registers_, reg + 1);
+        }
+
+        void emit(expr_op op, unsigned dst, unsigned a = 0, unsigned b = 0)
+        {
+            code_.push_back(expr_instr{op, static_cast<std::uint8_t>(dst), static_cast<std::uint8_t>(a),
+                                       static_cast<std::uint8_t>(b)});
+        }
+
+        const std::vector<expr_node>& nodes_;
+        std::vector<expr_instr>& code_;
+        std::vector<double>& constants_;
+        unsigned registers_ = 0;
+    };
+}
+
+CompiledExpression::CompiledExpression(const std::string& text) : text_(text)
+{
+    int root;
+    std::vector<expr_node> nodes = Parser(text).parse(root);
+
+    CodeGenerator generator(nodes, code_, constants_);
+    generator.generate(root, 0);
+    registers_ = generator.registers();
+}
+
+std::string CompiledExpression::disassemble() const
+{
+    static const char* names[] = {"x", "const", "copy", "neg", "add", "sub", "mul", "div",
+                                  "pow", "sqrt", "abs", "sin", "cos", "tan", "exp", "log"};
+
+    std::ostringstream out;
+    for (const expr_instr& in : code_)
+    {
+        out << "r" << int(in.dst) << " = " << names[static_cast<int>(in.op)];
+        if (in.op == expr_op::constant)
+            out << " " << constants_[in.a];
+        else if (in.op != expr_op::x)
+            out << " r" << int(in.a);
+        if (in.op >= expr_op::add && in.op <= expr_op::pow)
+            out << ", r" << int(in.b);
+        out << "\n";
+    }
+    return out.str();
+}
@@ -0,0 +1,197 @@
+/* Компилятор выражений для интегрируемой функции - основные моменты:
+    Строка (например "x*x - sin(x)/3") один раз разбирается в дерево, константные поддеревья
+    сворачиваются, затем дерево переводится в байткод регистровой машины.
+
+    Байткод:
+        Инструкция занимает 4 байта: операция, регистр результата и два регистра-операнда
+        (для загрузки константы второй байт - номер в таблице констант).
+        Регистры выделяются стеком, поэтому их нужно не больше глубины дерева.
+
+    Вычисление:
+        Одна и та же программа выполняется над double, __m256d, __m512d или над массивом из
+        integrate_block абсцисс: каждая инструкция обрабатывает сразу весь пакет, и затраты на
+        интерпретацию делятся на его размер. integrate/integrateParallel используют блочный вариант.
+        Арифметика и sqrt считаются SIMD-инструкциями, остальные функции - поэлементно. */
+
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "integrate.h"
+
+// Операции байткода
+enum class expr_op : std::uint8_t
+{
+    x,        // dst = x
+    constant, // dst = constants[a]
+    copy,     // dst = a
+    neg,      // dst = -a
+    add,      // dst = a + b
+    sub,      // dst = a - b
+    mul,      // dst = a * b
+    div,      // dst = a / b
+    pow,      // dst = a ^ b
+    sqrt,
+    abs,
+    sin,
+    cos,
+    tan,
+    exp,
+    log
+};
+
+// Инструкция регистровой машины
+struct expr_instr
+{
+    expr_op op;
+    std::uint8_t dst, a, b;
+};
+
+constexpr std::size_t expression_max_registers = 32; // Размер регистрового файла
+
+// Скалярное значение операции (для свёртки констант и поэлементных функций)
+double applyOperation(expr_op op, double a, double b);
+
+class CompiledExpression
+{
+public:
+    // Разбор и компиляция; при синтаксической ошибке бросает std::invalid_argument
+    explicit CompiledExpression(const std::string& text);
+
+    double operator()(double x) const { return run<1>(x); }
+
+#ifdef __AVX__
+    __m256d operator()(__m256d x) const { return run<4>(x); }
+#endif
+
+#ifdef __AVX512F__
+    __m512d operator()(__m512d x) const { return run<8>(x); }
+#endif
+
+    // Значения для массива абсцисс (count <= integrate_block): каждая инструкция выполняется сразу над
+    // всем массивом, поэтому разбор инструкции происходит один раз на integrate_block точек
+    void operator()(const double* x, double* y, std::size_t count) const { runBlock<simd_width>(x, y, count); }
+
+    const std::string& text() const { return text_; }
+    const std::vector<expr_instr>& code() const { return code_; }
+    std::size_t registers() const { return registers_; }
+
+    // Текстовое представление байткода
+    std::string disassemble() const;
+
+private:
+    template <std::size_t W>
+    typename simd_traits<W>::type run(typename simd_traits<W>::type x) const;
+
+    template <std::size_t W>
+    void runBlock(const double* x, double* y, std::size_t count) const;
+
+    std::string text_;
+    std::vector<expr_instr> code_;
+    std::vector<double> constants_;
+    std::size_t registers_ = 0;
+};
+
+// Выполнение программы над пакетом из W абсцисс
+template <std::size_t W>
+typename simd_traits<W>::type CompiledExpression::run(typename simd_traits<W>::type x) const
+{
+    using traits = simd_traits<W>;
+    using V = typename traits::type;
+
+    V regs[expression_max_registers];
+
+    // Операция без SIMD-аналога - считается для каждого элемента пакета отдельно
+    auto perLane = [](expr_op op, V a, V b)
+    {
+        alignas(64) double la[W], lb[W];
+        traits::store(la, a);
+        traits::store(lb, b);
+        for (std::size_t i = 0; i < W; i++)
+        {
+            la[i] = applyOperation(op, la[i], lb[i]);
+        }
+        return traits::load(la);
+    };
+
+    for (const expr_instr& in : code_)
+    {
+        V& dst = regs[in.dst];
+        switch (in.op)
+        {
+        case expr_op::x: dst = x; break;
+        case expr_op::constant: dst = traits::set1(constants_[in.a]); break;
+        case expr_op::copy: dst = regs[in.a]; break;
+        case expr_op::neg: dst = traits::sub(traits::set1(0), regs[in.a]); break;
+        case expr_op::add: dst = traits::add(regs[in.a], regs[in.b]); break;
+        case expr_op::sub: dst = traits::sub(regs[in.a], regs[in.b]); break;
+        case expr_op::mul: dst = traits::mul(regs[in.a], regs[in.b]); break;
+        case expr_op::div: dst = traits::div(regs[in.a], regs[in.b]); break;
+        case expr_op::sqrt: dst = traits::sqrt(regs[in.a]); break;
+        case expr_op::abs: dst = traits::max(regs[in.a], traits::sub(traits::set1(0), regs[in.a])); break;
+        default: dst = perLane(in.op, regs[in.a], regs[in.b]); break;
+        }
+    }
+
+    return regs[0];
+}
+
+// Выполнение программы над массивом абсцисс: регистр - массив из integrate_block значений
+template <std::size_t W>
+void CompiledExpression::runBlock(const double* x, double* y, std::size_t count) const
+{
+    using traits = simd_traits<W>;
+    using scalar = simd_traits<1>;
+
+    alignas(64) double regs[expression_max_registers][integrate_block];
+    const std::size_t full = count / W * W; // Часть массива, кратная ширине регистра
+    const std::size_t bytes = count * sizeof(double);
+
+    // Операция op над всем массивом: SIMD-пакетами, остаток - скалярно
+    auto apply = [&](double* dst, const double* a, const double* b, auto op)
+    {
+        std::size_t j = 0;
+        for (; j < full; j += W)
+        {
+            traits::store(dst + j, op(traits{}, traits::load(a + j), traits::load(b + j)));
+        }
+        for (; j < count; j++)
+        {
+            dst[j] = op(scalar{}, a[j], b[j]);
+        }
+    };
+
+    for (const expr_instr& in : code_)
+    {
+        double* dst = regs[in.dst];
+        const double* a = regs[in.a];
+        const double* b = regs[in.b];
+
+        switch (in.op)
+        {
+        case expr_op::x: std::memcpy(dst, x, bytes); break;
+        case expr_op::constant: std::fill(dst, dst + count, constants_[in.a]); break;
+        case expr_op::copy: std::memcpy(dst, a, bytes); break;
+        case expr_op::neg: apply(dst, a, a, [](auto t, auto u, auto) { return decltype(t)::sub(t.set1(0), u); }); break;
+        case expr_op::add: apply(dst, a, b, [](auto t, auto u, auto v) { return decltype(t)::add(u, v); }); break;
+        case expr_op::sub: apply(dst, a, b, [](auto t, auto u, auto v) { return decltype(t)::sub(u, v); }); break;
+        case expr_op::mul: apply(dst, a, b, [](auto t, auto u, auto v) { return decltype(t)::mul(u, v); }); break;
+        case expr_op::div: apply(dst, a, b, [](auto t, auto u, auto v) { return decltype(t)::div(u, v); }); break;
+        case expr_op::sqrt: apply(dst, a, a, [](auto t, auto u, auto) { return decltype(t)::sqrt(u); }); break;
+        case expr_op::abs:
+            apply(dst, a, a, [](auto t, auto u, auto) { return decltype(t)::max(u, t.sub(t.set1(0), u)); });
+            break;
+        default:
+            for (std::size_t j = 0; j < count; j++)
+            {
+                dst[j] = applyOperation(in.op, a[j], b[j]);
+            }
+            break;
+        }
+    }
+
+    std::memcpy(y, regs[0], bytes);
+}
@@ -0,0 +1,349 @@
+/* Численное интегрирование методом левых прямоугольников - шаблонные версии.
+    Интегрируемая функция передаётся как вызываемый объект (функтор, лямбда).
+    Если у функтора есть перегрузка для пакета абсцисс (__m512d при -mavx512f, __m256d при -mavx),
+    то точки обрабатываются целыми SIMD-регистрами, иначе используется скалярный вариант.
+    Функтор может также считать сразу массив абсцисс (f(x, y, count)) - тогда точки передаются блоками.
+
+    Точки делятся на integrate_blocks непрерывных блоков, суммы блоков складываются попарным деревом.
+    Число блоков и форма дерева не зависят от количества потоков, поэтому результат совпадает
+    бит в бит при любом T и с последовательной версией. */
+
+#pragma once
+#include <immintrin.h>
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <execution>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Если std::execution работает поверх TBB, через него можно ограничить число потоков
+#if __has_include(<tbb/global_control.h>)
+#include <tbb/global_control.h>
+#define INTEGRATE_HAS_TBB
+#endif
+
+// Константа для количества разбиений
+const double N = 100'000'000'0; // Количество разбиений для численного интегрирования
+
+// Количество блоков точек. Не зависит от числа потоков, поэтому результат одинаков при любом T
+constexpr std::size_t integrate_blocks = 4096;
+
+// Операции над SIMD-регистрами, нужные ядру интегрирования (по ширине пакета W)
+template <std::size_t W>
+struct simd_traits;
+
+// Вырожденный "регистр" из одного double - скалярный вариант тех же операций
+template <>
+struct simd_traits<1>
+{
+    using type = double;
+    static double set1(double v) { return v; }
+    static double iota() { return 0; }
+    static double add(double x, double y) { return x + y; }
+    static double sub(double x, double y) { return x - y; }
+    static double mul(double x, double y) { return x * y; }
+    static double div(double x, double y) { return x / y; }
+    static double max(double x, double y) { return x > y ? x : y; }
+    static double sqrt(double x) { return std::sqrt(x); }
+    static double load(const double* p) { return *p; }
+    static void store(double* p, double v) { *p = v; }
+    static double hsum(double v) { return v; }
+};
+
+#ifdef __AVX__
+template <>
+struct simd_traits<4>
+{
+    using type = __m256d; // 4 double в регистре
+    static __m256d set1(double v) { return _mm256_set1_pd(v); }
+    static __m256d iota() { return _mm256_set_pd(3, 2, 1, 0); }
+    static __m256d add(__m256d x, __m256d y) { return _mm256_add_pd(x, y); }
+    static __m256d sub(__m256d x, __m256d y) { return _mm256_sub_pd(x, y); }
+    static __m256d mul(__m256d x, __m256d y) { return _mm256_mul_pd(x, y); }
+    static __m256d div(__m256d x, __m256d y) { return _mm256_div_pd(x, y); }
+    static __m256d max(__m256d x, __m256d y) { return _mm256_max_pd(x, y); }
+    static __m256d sqrt(__m256d x) { return _mm256_sqrt_pd(x); }
+    static __m256d load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, __m256d v) { _mm256_storeu_pd(p, v); }
+    static double hsum(__m256d v)
+    {
+        __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+};
+#endif
+
+#ifdef __AVX512F__
+template <>
+struct simd_traits<8>
+{
+    using type = __m512d; // 8 double в регистре
+    static __m512d set1(double v) { return _mm512_set1_pd(v); }
+    static __m512d iota() { return _mm512_set_pd(7, 6, 5, 4, 3, 2, 1, 0); }
+    static __m512d add(__m512d x, __m512d y) { return _mm512_add_pd(x, y); }
+    static __m512d sub(__m512d x, __m512d y) { return _mm512_sub_pd(x, y); }
+    static __m512d mul(__m512d x, __m512d y) { return _mm512_mul_pd(x, y); }
+    static __m512d div(__m512d x, __m512d y) { return _mm512_div_pd(x, y); }
+    static __m512d max(__m512d x, __m512d y) { return _mm512_max_pd(x, y); }
+    static __m512d sqrt(__m512d x) { return _mm512_sqrt_pd(x); }
+    static __m512d load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, __m512d v) { _mm512_storeu_pd(p, v); }
+    static double hsum(__m512d v) { return _mm512_reduce_add_pd(v); }
+};
+#endif
+
+// Самый широкий регистр, доступный при текущих флагах компиляции
+#if defined(__AVX512F__)
+constexpr std::size_t simd_width = 8;
+#elif defined(__AVX__)
+constexpr std::size_t simd_width = 4;
+#else
+constexpr std::size_t simd_width = 1;
+#endif
+
+// Может ли функтор F посчитать значения сразу для пакета из W абсцисс
+template <class F, std::size_t W>
+concept batch_integrand = requires(const F& f, typename simd_traits<W>::type x) { x = f(x); };
+
+// Размер массива абсцисс для функторов, считающих значения блоками
+constexpr std::size_t integrate_block = 128;
+
+// Может ли функтор F посчитать значения для массива абсцисс: f(x, y, count), count <= integrate_block.
+// Так удобно функторам с большими накладными расходами на вызов (например, интерпретатору выражений)
+template <class F>
+concept block_integrand = requires(const F& f, const double* x, double* y, std::size_t count) { f(x, y, count); };
+
+// Сумма f(a + i * dx) для i из [begin, end) пакетами по W точек
+template <std::size_t W, class F>
+double sumPointsSimd(const F& f, double a, double dx, std::size_t begin, std::size_t end)
+{
+    using traits = simd_traits<W>;
+    using V = typename traits::type;
+
+    const V va = traits::set1(a);
+    const V vdx = traits::set1(dx);
+    const V step = traits::set1(2.0 * W);
+
+    // Номера точек храним в double: для i < 2^53 они точные, поэтому абсциссы совпадают со скалярными
+    V idx0 = traits::add(traits::set1(static_cast<double>(begin)), traits::iota());
+    V idx1 = traits::add(idx0, traits::set1(static_cast<double>(W)));
+
+    // Два независимых аккумулятора скрывают задержку сложения
+    V acc0 = traits::set1(0), acc1 = traits::set1(0);
+
+    const std::size_t full = begin + (end - begin) / (2 * W) * (2 * W); // Граница целых пакетов
+    for (std::size_t i = begin; i < full; i += 2 * W)
+    {
+        acc0 = traits::add(acc0, f(traits::add(va, traits::mul(idx0, vdx))));
+        acc1 = traits::add(acc1, f(traits::add(va, traits::mul(idx1, vdx))));
+        idx0 = traits::add(idx0, step);
+        idx1 = traits::add(idx1, step);
+    }
+
+    double sum = traits::hsum(traits::add(acc0, acc1));
+    for (std::size_t i = full; i < end; i++) // Хвост, не кратный ширине пакета
+    {
+        sum += f(a + i * dx);
+    }
+    return sum;
+}
+
+// Сумма f(a + i * dx) для i из [begin, end) блоками по integrate_block точек
+template <class F>
+double sumPointsBlock(const F& f, double a, double dx, std::size_t begin, std::size_t end)
+{
+    using traits = simd_traits<simd_width>;
+
+    alignas(64) double xs[integrate_block], ys[integrate_block];
+    auto acc = traits::set1(0);
+    double tail = 0;
+
+    for (std::size_t i = begin; i < end; i += integrate_block)
+    {
+        const std::size_t count = std::min(integrate_block, end - i);
+        const double first = static_cast<double>(i); // Номера точек точны в double, как и в sumPointsSimd
+        for (int j = 0; j < static_cast<int>(count); j++)
+        {
+            xs[j] = a + (first + j) * dx;
+        }
+
+        f(xs, ys, count);
+
+        std::size_t j = 0;
+        for (; j + simd_width <= count; j += simd_width)
+        {
+            acc = traits::add(acc, traits::load(ys + j));
+        }
+        for (; j < count; j++)
+        {
+            tail += ys[j];
+        }
+    }
+
+    return traits::hsum(acc) + tail;
+}
+
+// Сумма f(a + i * dx) для i из [begin, end): выбирается самый широкий поддерживаемый функтором пакет
+template <class F>
+double sumPoints(const F& f, double a, double dx, std::size_t begin, std::size_t end)
+{
+    if constexpr (block_integrand<F>)
+        return sumPointsBlock(f, a, dx, begin, end);
+    else
+#ifdef __AVX512F__
+    if constexpr (batch_integrand<F, 8>)
+        return sumPointsSimd<8>(f, a, dx, begin, end);
+    else
+#endif
+#ifdef __AVX__
+    if constexpr (batch_integrand<F, 4>)
+        return sumPointsSimd<4>(f, a, dx, begin, end);
+    else
+#endif
+    {
+        double sum = 0; // Скалярный запасной вариант
+        for (std::size_t i = begin; i < end; i++)
+        {
+            sum += f(a + i * dx);
+        }
+        return sum;
+    }
+}
+
+// Способ запуска потоков в integrateParallel, выбирается во время выполнения
+enum class integrate_backend
+{
+    openmp,   // #pragma omp parallel
+    threads,  // std::thread, как в lab4/lab5
+    par_unseq // std::for_each(std::execution::par_unseq, ...)
+};
+
+// Разбор имени бэкенда из командной строки
+inline bool parseBackend(const std::string& name, integrate_backend& backend)
+{
+    if (name == "openmp") backend = integrate_backend::openmp;
+    else if (name == "threads") backend = integrate_backend::threads;
+    else if (name == "par_unseq") backend = integrate_backend::par_unseq;
+    else return false;
+    return true;
+}
+
+inline const char* backendName(integrate_backend backend)
+{
+    switch (backend)
+    {
+    case integrate_backend::threads: return "threads";
+    case integrate_backend::par_unseq: return "par_unseq";
+    default: return "openmp";
+    }
+}
+
+// Частичная сумма одного блока, выровненная по кэш-линии (потоки не делят линии между собой)
+struct partial_sum_t
+{
+    alignas(64) double value;
+};
+
+// Диапазон [b, e) части k из parts при разбиении n элементов на непрерывные куски
+struct block_range
+{
+    std::size_t b, e;
+};
+
+inline block_range blockRange(std::size_t n, std::size_t parts, std::size_t k)
+{
+    return block_range{n * k / parts, n * (k + 1) / parts};
+}
+
+// Попарное суммирование в фиксированном порядке: форма дерева зависит только от count
+inline double pairwiseSum(const partial_sum_t* sums, std::size_t count)
+{
+    if (count == 1)
+        return sums[0].value;
+    const std::size_t half = count / 2;
+    return pairwiseSum(sums, half) + pairwiseSum(sums + half, count - half);
+}
+
+// Сумма одного блока: блок k покрывает точки blockRange(n, integrate_blocks, k)
+template <class F>
+void sumBlock(const F& f, double a, double dx, std::size_t n, std::size_t k, partial_sum_t& out)
+{
+    auto [b, e] = blockRange(n, integrate_blocks, k);
+    out.value = sumPoints(f, a, dx, b, e);
+}
+
+// Последовательное интегрирование методом прямоугольников
+template <class F>
+double integrate(const F& f, double a, double b, std::size_t n = N)
+{
+    double dx = (b - a) / n; // Шаг разбиения
+    std::vector<partial_sum_t> blocks(integrate_blocks);
+
+    // Те же блоки и то же дерево сложения, что и в параллельной версии - результат совпадает бит в бит
+    for (std::size_t k = 0; k < integrate_blocks; k++)
+    {
+        sumBlock(f, a, dx, n, k, blocks[k]);
+    }
+
+    return dx * pairwiseSum(blocks.data(), integrate_blocks);
+}
+
+// Параллельное интегрирование: непрерывные блоки точек и детерминированная редукция
+template <class F>
+double integrateParallel(const F& f, double a, double b, std::size_t n = N,
+                         integrate_backend backend = integrate_backend::openmp)
+{
+    double dx = (b - a) / n; // Шаг разбиения
+    std::vector<partial_sum_t> blocks(integrate_blocks); // Частичные суммы блоков
+
+    // Количество блоков не зависит от числа потоков, поток t получает непрерывную группу блоков.
+    // Поэтому каждая частичная сумма и порядок их сложения одинаковы при любом T
+    auto thread_lambda = [&](std::size_t t, std::size_t T)
+    {
+        auto [kb, ke] = blockRange(integrate_blocks, T, t);
+        for (std::size_t k = kb; k < ke; k++)
+        {
+            sumBlock(f, a, dx, n, k, blocks[k]);
+        }
+    };
+
+    switch (backend)
+    {
+    case integrate_backend::openmp:
+#pragma omp parallel // Начало параллельной секции
+        thread_lambda(omp_get_thread_num(), omp_get_num_threads());
+        break;
+
+    case integrate_backend::threads:
+    {
+        std::size_t T = omp_get_max_threads(); // Количество потоков задаётся через omp_set_num_threads
+        std::vector<std::thread> threads(T - 1);
+        for (std::size_t t = 1; t < T; ++t)
+        {
+            threads[t - 1] = std::thread(thread_lambda, t, T);
+        }
+        thread_lambda(0, T); // Работа основного потока
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        break;
+    }
+
+    case integrate_backend::par_unseq:
+    {
+#ifdef INTEGRATE_HAS_TBB
+        // Ограничиваем пул TBB тем же количеством потоков, что и остальные бэкенды
+        tbb::global_control limit(tbb::global_control::max_allowed_parallelism, omp_get_max_threads());
+#endif
+        std::for_each(std::execution::par_unseq, blocks.begin(), blocks.end(),
+                      [&](partial_sum_t& block) { sumBlock(f, a, dx, n, &block - blocks.data(), block); });
+        break;
+    }
+    }
+
+    return dx * pairwiseSum(blocks.data(), integrate_blocks); // Редукция деревом фиксированной формы
+}
@@ -4,16 +4,40 @@
     Последовательное интегрирование (integrate):
         Используется метод прямоугольников для численного интегрирования.
         Цикл проходит по всем разбиениям и суммирует значения функции.
+        integrate и integrateParallel - шаблоны (integrate.h) над функтором: если он умеет
+        считать пакет __m256d/__m512d, точки обрабатываются SIMD-регистрами.
 
     Параллельное интегрирование (integrateParallel):
-        Используется OpenMP для распараллеливания вычислений.
-        Каждый поток обрабатывает свою часть данных, а затем результаты суммируются в критической секции.
+        Каждый поток обрабатывает свою непрерывную группу блоков точек, суммы блоков складываются
+        деревом фиксированной формы - значение не зависит от количества потоков.
+        Потоки запускаются через OpenMP, std::thread или std::execution::par_unseq (ключ --backend=).
 
     Измерение времени:
         Время выполнения измеряется с помощью omp_get_wtime().
         Для каждого количества потоков (от 1 до максимального) выполняется несколько экспериментов для усреднения времени.
 
-    Результаты (время выполнения и значение интеграла) выводятся в консоль и записываются в файл output.csv. */
+    Результаты (время выполнения и значение интеграла) выводятся в консоль и записываются в файл output.csv.
+
+    Режим adaptive (./lab1 adaptive):
+        Адаптивное интегрирование G7K15 с work stealing (adaptive.h) сравнивается с integrateParallel
+        по времени и количеству вычислений функции. Результаты пишутся в output_adaptive.csv.
+
+    Режим batch (./lab1 batch):
+        Пакет из множества небольших интегралов с параметризованной функцией считается одним вызовом
+        integrateBatch (batch.h). Пропускная способность (интегралов в секунду) пишется в output_batch.csv.
+
+    Функция из строки (--f="x*x - sin(x)/3"):
+        Выражение компилируется в байткод (expression.h) и интегрируется теми же шаблонами вместо f.
+        Режим expression (./lab1 expression --f="...") сравнивает его скорость с функтором Integrand
+        и пишет результат в output_expression.csv.
+
+    Режим montecarlo (./lab1 montecarlo --dims=10):
+        Многомерный интеграл методами Монте-Карло, Холтона и Соболя (montecarlo.h) с оценкой погрешности
+        по независимым наборам точек. Время при разном количестве потоков пишется в output_montecarlo.csv.
+
+    Режим tabulated (./lab1 tabulated --file=data.bin [--type=float]):
+        Файл значений функции отображается в память и интегрируется по формулам трапеций и Симпсона
+        (tabulated.h). Время и скорость чтения (ГБ/с) пишутся в output_tabulated.csv. */
 
 
 #include <iostream>
@@ -22,9 +46,18 @@
 #include <thread> // Для работы с потоками
 #include <fstream> // Для работы с файлами
 #include "vector"  // Для использования std::vector
+#include "integrate.h" // Шаблонные integrate и integrateParallel
+#include "adaptive.h"  // Адаптивное интегрирование Гаусса-Кронрода
+#include "batch.h"     // Пакетное интегрирование множества заданий
+#include "expression.h" // Компиляция функции из строки
+#include "montecarlo.h" // Многомерное интегрирование (квази-)Монте-Карло
+#include "tabulated.h"  // Интегрирование значений из файла
+#include <charconv>
+#include <memory>
+#include <stdexcept>
+#include <string>
 
-// Константы для количества разбиений и количества экспериментов
-const double N = 100'000'000'0; // Количество разбиений для численного интегрирования
+// Количество экспериментов для усреднения времени
 const size_t experiments = 10; // Количество экспериментов для усреднения времени
 
 // Функция, которую мы интегрируем
@@ -33,49 +66,354 @@ double f(double x)
     return x * x - 1; // Пример функции: f(x) = x^2 - 1
 }
 
-// Последовательное интегрирование методом прямоугольников
-double integrate(double a, double b)
+// Та же функция в виде функтора: помимо скалярной версии умеет считать пакет абсцисс в SIMD-регистре
+struct Integrand
 {
-    double sum = 0; // Сумма значений функции
-    double dx = (b - a) / N; // Шаг разбиения
+    double operator()(double x) const { return f(x); }
 
-    // Цикл по всем разбиениям
-    for (int i = 0; i < N; i++)
+#ifdef __AVX__
+    __m256d operator()(__m256d x) const
     {
-        sum += f(a + i * dx); // Добавляем значение функции в текущей точке
+        return _mm256_sub_pd(_mm256_mul_pd(x, x), _mm256_set1_pd(1));
     }
+#endif
 
-    return dx * sum; // Возвращаем результат интегрирования
+#ifdef __AVX512F__
+    __m512d operator()(__m512d x) const
+    {
+        return _mm512_sub_pd(_mm512_mul_pd(x, x), _mm512_set1_pd(1));
+    }
+#endif
+};
+
+// Функция с острым пиком в точке 0.3: на ней адаптивное деление действительно нужно
+double peak(double x)
+{
+    return 1 / (1e-4 + (x - 0.3) * (x - 0.3));
 }
 
-// Параллельное интегрирование с использованием OpenMP
-double integrateParallel(double a, double b)
+// Сравнение адаптивного интегрирования с integrateParallel при разном количестве потоков
+template <class F>
+void adaptiveExperiment(std::ofstream& output, const char* name, const F& func, double a, double b, double tolerance)
 {
-    double sum = 0; // Общая сумма значений функции
-    double dx = (b - a) / N; // Шаг разбиения
+    const size_t threadCount = std::thread::hardware_concurrency();
+
+    std::cout << name << ": tolerance " << tolerance << "\n";
+    std::cout << "thread\t duration\t value\t\t error\t\t evaluations\t intervals\n";
 
-#pragma omp parallel // Начало параллельной секции
+    for (size_t i = 1; i <= threadCount; i++)
     {
-        unsigned t = omp_get_thread_num(); // Номер текущего потока
-        unsigned T = omp_get_num_threads(); // Общее количество потоков
-        double threadSum = 0; // Локальная сумма для текущего потока
+        omp_set_num_threads(i); // Устанавливаем количество потоков
+        adaptive_result result{};
+        double totalTime = 0;
+        for (size_t trial = 0; trial < experiments; trial++)
+        {
+            double t1 = omp_get_wtime();
+            result = integrateAdaptive(func, a, b, tolerance);
+            double t2 = omp_get_wtime();
+            totalTime += t2 - t1;
+        }
+
+        double duration = 1000 * totalTime / experiments; // Среднее время в миллисекундах
+        std::cout << i << "\t " << duration << "\t\t " << result.value << "\t " << result.error << "\t "
+                  << result.evaluations << "\t\t " << result.intervals << "\n";
+        output << name << "," << i << "," << duration << "," << result.value << "," << result.error << ","
+               << result.evaluations << "\n";
+    }
+
+    // Для сравнения - один прогон integrateParallel со всеми потоками (N вычислений функции)
+    omp_set_num_threads(threadCount);
+    double t1 = omp_get_wtime();
+    double value = integrateParallel(func, a, b);
+    double t2 = omp_get_wtime();
+    std::cout << "integrateParallel: " << 1000 * (t2 - t1) << " ms, value " << value << ", evaluations "
+              << static_cast<size_t>(N) << "\n\n";
+}
 
-        // Каждый поток обрабатывает свою часть данных
-        for (size_t i = t; i < N; i += T)
+// Режим "adaptive": результаты записываются в output_adaptive.csv
+int adaptiveMain()
+{
+    std::ofstream output("../output_adaptive.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    output << "function,thread,duration,value,error,evaluations\n";
+    adaptiveExperiment(output, "x^2-1", Integrand{}, 0, 1, 1e-10);
+    adaptiveExperiment(output, "peak", peak, 0, 1, 1e-10);
+
+    output.close();
+    return 0;
+}
+
+// Параметризованная функция f(x) = k * x^2 - 1 для пакетных заданий
+struct ScaledIntegrand
+{
+    double k;
+
+    double operator()(double x) const { return k * x * x - 1; }
+
+#ifdef __AVX__
+    __m256d operator()(__m256d x) const
+    {
+        return _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(k), _mm256_mul_pd(x, x)), _mm256_set1_pd(1));
+    }
+#endif
+
+#ifdef __AVX512F__
+    __m512d operator()(__m512d x) const
+    {
+        return _mm512_sub_pd(_mm512_mul_pd(_mm512_set1_pd(k), _mm512_mul_pd(x, x)), _mm512_set1_pd(1));
+    }
+#endif
+};
+
+// Режим "batch": пропускная способность пакетного интегрирования (интегралов в секунду),
+// результаты записываются в output_batch.csv
+int batchMain()
+{
+    std::ofstream output("../output_batch.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    const size_t jobCount = 100'000; // Количество интегралов в пакете
+    const size_t points = 1000;      // Разбиений на один интеграл
+
+    // Маленькие отрезки [a, a + 0.01] с разными параметрами функции
+    std::vector<integral_job<ScaledIntegrand>> jobs(jobCount);
+    for (size_t i = 0; i < jobCount; i++)
+    {
+        double a = static_cast<double>(i) / jobCount;
+        jobs[i] = integral_job<ScaledIntegrand>{ScaledIntegrand{1 + (i % 7) * 0.5}, a, a + 0.01, points};
+    }
+
+    const size_t threadCount = std::thread::hardware_concurrency();
+    std::vector<double> results;
+
+    std::cout << "thread\t duration\t integrals/s\n";
+    output << "thread,duration,integrals_per_second\n";
+
+    for (size_t i = 1; i <= threadCount; i++)
+    {
+        omp_set_num_threads(i); // Устанавливаем количество потоков
+        double totalTime = 0;
+        for (size_t trial = 0; trial < experiments; trial++)
         {
-            threadSum += f(a + i * dx); // Добавляем значение функции в текущей точке
+            double t1 = omp_get_wtime();
+            results = integrateBatch(jobs);
+            double t2 = omp_get_wtime();
+            totalTime += t2 - t1;
         }
 
-#pragma omp critical // Критическая секция для безопасного обновления общей суммы
+        double duration = 1000 * totalTime / experiments; // Среднее время в миллисекундах
+        double throughput = jobCount / (totalTime / experiments);
+        std::cout << i << "\t " << duration << "\t\t " << throughput << "\n";
+        output << i << "," << duration << "," << throughput << "\n";
+    }
+
+    // Для сравнения - те же задания по одному через integrateParallel (своя параллельная секция на каждый)
+    double t1 = omp_get_wtime();
+    double maxDifference = 0;
+    for (size_t i = 0; i < jobCount; i++)
+    {
+        double value = integrateParallel(jobs[i].f, jobs[i].a, jobs[i].b, jobs[i].n);
+        maxDifference = std::max(maxDifference, std::abs(value - results[i]));
+    }
+    double t2 = omp_get_wtime();
+    std::cout << "integrateParallel per job: " << 1000 * (t2 - t1) << " ms, " << jobCount / (t2 - t1)
+              << " integrals/s, max difference " << maxDifference << "\n";
+
+    output.close();
+    return 0;
+}
+
+// Режим "expression": скорость скомпилированного выражения против функтора Integrand,
+// результаты записываются в output_expression.csv
+int expressionMain(const CompiledExpression& expression)
+{
+    std::ofstream output("../output_expression.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    std::cout << "Expression: " << expression.text() << " (" << expression.code().size() << " instructions, "
+              << expression.registers() << " registers)\n" << expression.disassemble();
+
+    const size_t threadCount = std::thread::hardware_concurrency();
+    const double a = 0;
+    const double b = 1;
+
+    // Время integrateParallel с функцией func при T потоках, в миллисекундах
+    auto measure = [&](const auto& func, size_t T, double& value)
+    {
+        omp_set_num_threads(T);
+        double totalTime = 0;
+        for (size_t trial = 0; trial < experiments; trial++)
         {
-            sum += threadSum; // Добавляем локальную сумму к общей
+            double t1 = omp_get_wtime();
+            value = integrateParallel(func, a, b);
+            double t2 = omp_get_wtime();
+            totalTime += t2 - t1;
         }
+        return 1000 * totalTime / experiments;
+    };
+
+    std::cout << "thread\t f, ms\t\t expression, ms\t f, points/s\t expression, points/s\t value\n";
+    output << "thread,duration_f,duration_expression,points_per_second_f,points_per_second_expression\n";
+
+    for (size_t i = 1; i <= threadCount; i++)
+    {
+        double valueF, valueExpression;
+        double durationF = measure(Integrand{}, i, valueF);
+        double durationExpression = measure(expression, i, valueExpression);
+        double pointsF = N / (durationF / 1000);
+        double pointsExpression = N / (durationExpression / 1000);
+
+        std::cout << i << "\t " << durationF << "\t\t " << durationExpression << "\t\t " << pointsF << "\t "
+                  << pointsExpression << "\t\t " << valueExpression << "\n";
+        output << i << "," << durationF << "," << durationExpression << "," << pointsF << "," << pointsExpression
+               << "\n";
     }
 
-    return dx * sum; // Возвращаем результат интегрирования
+    output.close();
+    return 0;
 }
 
-int main()
+// Режим "montecarlo": многомерный интеграл функции Соболя g(x) = prod (|4x_d - 2| + d) / (1 + d)
+// по единичному кубу (точное значение 1), результаты записываются в output_montecarlo.csv
+int monteCarloMain(std::size_t dims)
+{
+    std::ofstream output("../output_montecarlo.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    const std::size_t points = 1 << 24; // Количество точек на один интеграл
+    const std::vector<double> lower(dims, 0), upper(dims, 1);
+
+    auto g = [dims](const double* x)
+    {
+        double product = 1;
+        for (std::size_t d = 0; d < dims; d++)
+        {
+            product *= (std::abs(4 * x[d] - 2) + d) / (1 + d);
+        }
+        return product;
+    };
+
+    const size_t threadCount = std::thread::hardware_concurrency();
+    const std::pair<const char*, mc_sequence> methods[] = {
+        {"random", mc_sequence::random}, {"halton", mc_sequence::halton}, {"sobol", mc_sequence::sobol}};
+
+    std::cout << "Dimension: " << dims << ", points: " << points << "\n";
+    std::cout << "method\t thread\t duration\t value\t\t error\n";
+    output << "method,thread,duration,value,error\n";
+
+    for (const auto& [name, sequence] : methods)
+    {
+        for (size_t i = 1; i <= threadCount; i++)
+        {
+            omp_set_num_threads(i); // Устанавливаем количество потоков
+            mc_result result{};
+            double totalTime = 0;
+            for (size_t trial = 0; trial < experiments; trial++)
+            {
+                double t1 = omp_get_wtime();
+                result = integrateMonteCarlo(g, lower, upper, points, sequence);
+                double t2 = omp_get_wtime();
+                totalTime += t2 - t1;
+            }
+
+            double duration = 1000 * totalTime / experiments; // Среднее время в миллисекундах
+            std::cout << name << "\t " << i << "\t " << duration << "\t\t " << result.value << "\t " << result.error
+                      << "\n";
+            output << name << "," << i << "," << duration << "," << result.value << "," << result.error << "\n";
+        }
+    }
+
+    output.close();
+    return 0;
+}
+
+// Режим "tabulated": интегрирование значений функции из двоичного файла, отображённого в память.
+// Если файл не задан, он создаётся из f. Время и скорость чтения пишутся в output_tabulated.csv
+int tabulatedMain(std::string path, sample_type type)
+{
+    const double a = 0;
+    const double b = 1;
+
+    try
+    {
+        if (path.empty())
+        {
+            path = "../samples.bin";
+            const std::size_t count = (std::size_t(1) << 27) + 1; // 1 ГиБ значений double
+            std::cout << "Writing " << count << " samples of f to " << path << "\n";
+            writeSamples(path, f, a, b, count, type);
+        }
+
+        MappedSamples samples(path, type);
+
+        std::ofstream output("../output_tabulated.csv");
+        if (!output.is_open())
+        {
+            std::cout << "Couldn't open file!\n";
+            return -1;
+        }
+
+        std::cout << "Samples: " << samples.size() << " (" << samples.bytes() / double(1 << 30) << " GiB)\n";
+        std::cout << "thread\t duration\t GB/s\t\t trapezoid\t simpson\n";
+        output << "thread,duration,gb_per_second\n";
+
+        const size_t threadCount = std::thread::hardware_concurrency();
+        for (size_t i = 1; i <= threadCount; i++)
+        {
+            omp_set_num_threads(i); // Устанавливаем количество потоков
+            double trapezoid = 0, simpson = 0;
+            double totalTime = 0;
+            for (size_t trial = 0; trial < experiments; trial++)
+            {
+                double t1 = omp_get_wtime();
+                simpson = integrateSamples(samples, a, b, tabulated_rule::simpson);
+                double t2 = omp_get_wtime();
+                totalTime += t2 - t1;
+            }
+            trapezoid = integrateSamples(samples, a, b, tabulated_rule::trapezoid);
+
+            double duration = 1000 * totalTime / experiments; // Среднее время в миллисекундах
+            double throughput = samples.bytes() / (totalTime / experiments) / 1e9;
+            std::cout << i << "\t " << duration << "\t\t " << throughput << "\t\t " << trapezoid << "\t "
+                      << simpson << "\n";
+            output << i << "," << duration << "," << throughput << "\n";
+        }
+
+        output.close();
+    }
+    catch (const std::runtime_error& error)
+    {
+        std::cout << error.what() << "\n";
+        return -1;
+    }
+
+    return 0;
+}
+
+// Исходный замер: последовательное интегрирование и integrateParallel при разном количестве потоков
+template <class F>
+int sweepMain(const F& func, integrate_backend backend)
 {
     std::ofstream output("../output.csv"); // Открываем файл для записи результатов
 
@@ -88,6 +426,7 @@ int main()
     // Определяем количество потоков, поддерживаемых системой
     const size_t threadCount = std::thread::hardware_concurrency();
     std::cout << "Number of available threads:  " << threadCount << "\n";
+    std::cout << "Backend: " << backendName(backend) << "\n";
 
     // Границы интегрирования
     const double a = 0;
@@ -105,7 +444,7 @@ int main()
     // Последовательное интегрирование
     for(size_t i = 0; i < experiments; ++i){
         double t1 = omp_get_wtime(); // Начало измерения времени
-        result = integrate(a, b); // Вызов последовательного интегрирования
+        result = integrate(func, a, b); // Вызов последовательного интегрирования
         double t2 = omp_get_wtime(); // Конец измерения времени
         totalTime += t2 - t1; // Суммируем время выполнения
     }
@@ -121,7 +460,7 @@ int main()
         for(size_t trial = 0; trial < experiments; trial++){
             omp_set_num_threads(i); // Устанавливаем количество потоков
             t1 = omp_get_wtime(); // Начало измерения времени
-            result = integrateParallel(a, b); // Вызов параллельного интегрирования
+            result = integrateParallel(func, a, b, N, backend); // Вызов параллельного интегрирования
             t2 = omp_get_wtime(); // Конец измерения времени
             totalTime += t2 - t1; // Суммируем время выполнения
         }
@@ -142,4 +481,99 @@ int main()
 
     output.close(); // Закрываем файл
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char** argv)
+{
+    // Режим работы задаётся первым аргументом, без аргументов - исходный замер.
+    // Бэкенд integrateParallel выбирается ключом --backend=openmp|threads|par_unseq
+    // Функция задаётся строкой ключом --f="выражение" (по умолчанию - функтор Integrand)
+    std::string mode;
+    std::string function;
+    std::size_t dims = 10; // Размерность для режима montecarlo (--dims=)
+    std::string samplesPath; // Файл значений для режима tabulated (--file=, --type=float)
+    sample_type samplesType = sample_type::float64;
+    integrate_backend backend = integrate_backend::openmp;
+    for (int arg = 1; arg < argc; arg++)
+    {
+        const std::string option = argv[arg];
+        if (option.rfind("--backend=", 0) == 0)
+        {
+            if (!parseBackend(option.substr(10), backend))
+            {
+                std::cout << "Unknown backend: " << option.substr(10) << "\n";
+                return -1;
+            }
+        }
+        else if (option.rfind("--f=", 0) == 0)
+        {
+            function = option.substr(4);
+        }
+        else if (option.rfind("--file=", 0) == 0)
+        {
+            samplesPath = option.substr(7);
+        }
+        else if (option == "--type=float")
+        {
+            samplesType = sample_type::float32;
+        }
+        else if (option.rfind("--dims=", 0) == 0)
+        {
+            const char* first = option.data() + 7;
+            const char* last = option.data() + option.size();
+            auto [ptr, error] = std::from_chars(first, last, dims);
+            if (error != std::errc() || ptr != last || dims == 0 || dims > mc_max_dims)
+            {
+                std::cout << "Dimension must be in [1, " << mc_max_dims << "]\n";
+                return -1;
+            }
+        }
+        else
+        {
+            mode = option;
+        }
+    }
+
+    // Выражение разбирается и компилируется в байткод один раз
+    std::unique_ptr<CompiledExpression> expression;
+    if (!function.empty() || mode == "expression")
+    {
+        try
+        {
+            expression = std::make_unique<CompiledExpression>(function.empty() ? "x*x - 1" : function);
+        }
+        catch (const std::invalid_argument& error)
+        {
+            std::cout << error.what() << "\n";
+            return -1;
+        }
+    }
+
+    if (mode == "adaptive")
+    {
+        return adaptiveMain();
+    }
+    if (mode == "batch")
+    {
+        return batchMain();
+    }
+    if (mode == "expression")
+    {
+        return expressionMain(*expression);
+    }
+    if (mode == "montecarlo")
+    {
+        return monteCarloMain(dims);
+    }
+    if (mode == "tabulated")
+    {
+        return tabulatedMain(samplesPath, samplesType);
+    }
+
+    if (expression)
+    {
+        return sweepMain(*expression, backend);
+    }
+    return sweepMain(Integrand{}, backend);
+}
+
@@ -0,0 +1,146 @@
+/* Генераторы точек для integrateMonteCarlo.
+    * philox4x32 - счётный генератор Philox4x32-10 (Salmon и др., Random123).
+    * radicalInverse / haltonBase - координаты последовательности Холтона.
+    * SobolSequence - направляющие числа Соболя по таблице Джо-Куо (new-joe-kuo-6.21201). */
+
+#include "montecarlo.h"
+#include <bit>
+
+void philox4x32(const std::uint32_t counter[4], const std::uint32_t key[2], std::uint32_t out[4])
+{
+    std::uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    std::uint32_t k0 = key[0], k1 = key[1];
+
+    for (int round = 0; round < 10; round++)
+    {
+        const std::uint64_t p0 = static_cast<std::uint64_t>(0xD2511F53u) * c0;
+        const std::uint64_t p1 = static_cast<std::uint64_t>(0xCD9E8D57u) * c2;
+        c0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1 ^ k0;
+        c2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3 ^ k1;
+        c1 = static_cast<std::uint32_t>(p1);
+        c3 = static_cast<std::uint32_t>(p0);
+        k0 += 0x9E3779B9u; // Смена ключа между раундами
+        k1 += 0xBB67AE85u;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+double radicalInverse(std::uint64_t index, unsigned base)
+{
+    const double inverse = 1.0 / base;
+    double factor = inverse;
+    double result = 0;
+    while (index > 0)
+    {
+        result += (index % base) * factor;
+        index /= base;
+        factor *= inverse;
+    }
+    return result;
+}
+
+unsigned haltonBase(std::size_t d)
+{
+    static const unsigned primes[mc_max_dims] = {2,  3,  5,  7,  11, 13, 17, 19, 23, 29,
+                                                 31, 37, 41, 43, 47, 53, 59, 61, 67, 71};
+    return primes[d];
+}
+
+namespace
+{
+    // Примитивный многочлен степени s с коэффициентами a и начальные числа m_1..m_s для координаты
+    struct sobol_parameters
+    {
+        unsigned s;
+        unsigned a;
+        std::uint32_t m[7];
+    };
+
+    // Координаты 2..20 (первая координата - обращение номера по основанию 2)
+    const sobol_parameters sobol_table[mc_max_dims - 1] = {
+        {1, 0, {1}},
+        {2, 1, {1, 3}},
+        {3, 1, {1, 3, 1}},
+        {3, 2, {1, 1, 1}},
+        {4, 1, {1, 1, 3, 3}},
+        {4, 4, {1, 3, 5, 13}},
+        {5, 2, {1, 1, 5, 5, 17}},
+        {5, 4, {1, 1, 5, 5, 5}},
+        {5, 7, {1, 1, 7, 11, 19}},
+        {5, 11, {1, 1, 5, 1, 1}},
+        {5, 13, {1, 1, 1, 3, 11}},
+        {5, 14, {1, 3, 5, 5, 31}},
+        {6, 1, {1, 3, 3, 9, 7, 49}},
+        {6, 13, {1, 1, 1, 15, 21, 21}},
+        {6, 16, {1, 3, 1, 13, 27, 49}},
+        {6, 19, {1, 1, 1, 15, 7, 5}},
+        {6, 22, {1, 3, 1, 15, 13, 25}},
+        {6, 25, {1, 1, 5, 5, 19, 61}},
+        {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+    };
+
+    constexpr unsigned sobol_bits = 32;
+}
+
+SobolSequence::SobolSequence(std::size_t dims) : dims_(dims), directions_(dims * sobol_bits)
+{
+    if (dims > mc_max_dims)
+        throw std::invalid_argument("SobolSequence: unsupported dimension");
+
+    // Первая координата: v_k = 2^(32 - k)
+    for (unsigned k = 0; k < sobol_bits; k++)
+    {
+        directions_[k] = 1u << (sobol_bits - 1 - k);
+    }
+
+    for (std::size_t d = 1; d < dims; d++)
+    {
+        const sobol_parameters& p = sobol_table[d - 1];
+        std::uint32_t* v = directions_.data() + d * sobol_bits;
+
+        for (unsigned k = 0; k < p.s; k++)
+        {
+            v[k] = p.m[k] << (sobol_bits - 1 - k);
+        }
+
+        // Рекуррентное соотношение по коэффициентам примитивного многочлена
+        for (unsigned k = p.s; k < sobol_bits; k++)
+        {
+            v[k] = v[k - p.s] ^ (v[k - p.s] >> p.s);
+            for (unsigned j = 1; j < p.s; j++)
+            {
+                if ((p.a >> (p.s - 1 - j)) & 1)
+                    v[k] ^= v[k - j];
+            }
+        }
+    }
+}
+
+void SobolSequence::point(std::uint64_t index, std::uint32_t* x) const
+{
+    const std::uint64_t gray = index ^ (index >> 1);
+    for (std::size_t d = 0; d < dims_; d++)
+    {
+        std::uint32_t value = 0;
+        for (unsigned k = 0; k < sobol_bits; k++)
+        {
+            if ((gray >> k) & 1)
+                value ^= directions_[d * sobol_bits + k];
+        }
+        x[d] = value;
+    }
+}
+
+void SobolSequence::next(std::uint64_t index, std::uint32_t* x) const
+{
+    // Соседние коды Грея отличаются одним битом - номером младшего единичного бита index
+    const unsigned bit = std::countr_zero(index);
+    for (std::size_t d = 0; d < dims_; d++)
+    {
+        x[d] ^= directions_[d * sobol_bits + bit];
+    }
+}
@@ -0,0 +1,211 @@
+/* Многомерное интегрирование методами Монте-Карло и квази-Монте-Карло - основные моменты:
+    Последовательности точек:
+        * random - псевдослучайные точки из счётного генератора Philox4x32-10: точка с номером i
+          вычисляется напрямую из (ключ, i), поэтому поток начинает свой блок без прогона генератора.
+        * halton - последовательность Холтона (обращение номера в системах по простым основаниям).
+        * sobol  - последовательность Соболя (направляющие числа Джо-Куо), точки перебираются в порядке
+          кода Грея: первая точка блока считается напрямую, следующие - одним XOR на координату.
+
+    Оценка погрешности:
+        Интеграл считается R раз (replicates) на независимых наборах точек: для random - разные ключи
+        генератора, для halton/sobol - случайные сдвиги (сдвиг по модулю 1 и цифровой сдвиг XOR).
+        Значение - среднее по наборам, погрешность - стандартная ошибка этого среднего.
+
+    Распараллеливание устроено как в integrateParallel: точки каждого набора делятся на фиксированное
+    число непрерывных блоков, поток получает непрерывную группу блоков, суммы блоков складываются
+    попарным деревом. Результат не зависит от количества потоков. */
+
+#pragma once
+#include <omp.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "integrate.h"
+
+constexpr std::size_t mc_max_dims = 20; // Наибольшая поддерживаемая размерность
+
+// Способ выбора точек
+enum class mc_sequence
+{
+    random,
+    halton,
+    sobol
+};
+
+// Результат интегрирования
+struct mc_result
+{
+    double value;       // Среднее значение интеграла по наборам точек
+    double variance;    // Выборочная дисперсия значений по наборам
+    double error;       // Стандартная ошибка среднего
+    std::size_t points; // Общее количество вычислений функции
+};
+
+// Счётный генератор Philox4x32-10: 128 случайных бит по счётчику и ключу
+void philox4x32(const std::uint32_t counter[4], const std::uint32_t key[2], std::uint32_t out[4]);
+
+// Равномерное число из (0, 1) по двум 32-битным словам (53 значащих бита)
+inline double uniformDouble(std::uint32_t hi, std::uint32_t lo)
+{
+    const std::uint64_t bits = (static_cast<std::uint64_t>(hi) << 32 | lo) >> 11;
+    return (static_cast<double>(bits) + 0.5) * 0x1p-53;
+}
+
+// Обращение номера index в системе счисления с основанием base (координата точки Холтона)
+double radicalInverse(std::uint64_t index, unsigned base);
+
+// Простое основание для координаты d последовательности Холтона
+unsigned haltonBase(std::size_t d);
+
+// Направляющие числа последовательности Соболя
+class SobolSequence
+{
+public:
+    explicit SobolSequence(std::size_t dims);
+
+    // Точка с номером index в порядке кода Грея (32-битные координаты)
+    void point(std::uint64_t index, std::uint32_t* x) const;
+
+    // Переход от точки index - 1 к точке index
+    void next(std::uint64_t index, std::uint32_t* x) const;
+
+private:
+    std::size_t dims_;
+    std::vector<std::uint32_t> directions_; // dims_ x 32
+};
+
+// Интегрирование f по прямоугольнику [lower, upper] на n точках, разбитых на replicates наборов
+template <class F>
+mc_result integrateMonteCarlo(const F& f, const std::vector<double>& lower, const std::vector<double>& upper,
+                              std::size_t n, mc_sequence sequence, std::uint64_t seed = 1,
+                              std::size_t replicates = 16)
+{
+    const std::size_t dims = lower.size();
+    if (dims == 0 || dims > mc_max_dims || upper.size() != dims)
+        throw std::invalid_argument("integrateMonteCarlo: unsupported dimension");
+    if (replicates < 2 || replicates > integrate_blocks || n < replicates)
+        throw std::invalid_argument("integrateMonteCarlo: replicates must be in [2, min(integrate_blocks, n)]");
+
+    const std::size_t m = n / replicates;                        // Точек в одном наборе
+    const std::size_t blocksPer = integrate_blocks / replicates; // Блоков в одном наборе
+    const std::size_t totalBlocks = blocksPer * replicates;
+    const std::uint32_t key[2] = {static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)};
+
+    double volume = 1;
+    for (std::size_t d = 0; d < dims; d++)
+    {
+        volume *= upper[d] - lower[d];
+    }
+
+    // Случайные сдвиги наборов для halton/sobol (своя область счётчика генератора)
+    std::vector<double> shifts(replicates * dims);
+    std::vector<std::uint32_t> digitalShifts(replicates * dims);
+    for (std::size_t r = 0; r < replicates; r++)
+    {
+        for (std::size_t d = 0; d < dims; d++)
+        {
+            const std::uint32_t counter[4] = {static_cast<std::uint32_t>(r), static_cast<std::uint32_t>(d), 0,
+                                              0xFFFFFFFFu};
+            std::uint32_t bits[4];
+            philox4x32(counter, key, bits);
+            shifts[r * dims + d] = uniformDouble(bits[0], bits[1]);
+            digitalShifts[r * dims + d] = bits[2];
+        }
+    }
+
+    const SobolSequence sobol(sequence == mc_sequence::sobol ? dims : 1);
+    std::vector<partial_sum_t> blocks(totalBlocks); // Суммы блоков, по кэш-линии на блок
+
+    // Сумма значений функции в одном блоке (блок k набора r)
+    auto sumBlock = [&](std::size_t item)
+    {
+        const std::size_t r = item / blocksPer;
+        auto [b, e] = blockRange(m, blocksPer, item % blocksPer);
+
+        double u[mc_max_dims], x[mc_max_dims];
+        std::uint32_t s[mc_max_dims];
+        double sum = 0;
+
+        if (sequence == mc_sequence::sobol && b < e)
+            sobol.point(b, s); // Прямой пропуск к началу блока
+
+        for (std::size_t i = b; i < e; i++)
+        {
+            switch (sequence)
+            {
+            case mc_sequence::random:
+                for (std::size_t d = 0; d < dims; d += 2)
+                {
+                    const std::uint32_t counter[4] = {static_cast<std::uint32_t>(i),
+                                                      static_cast<std::uint32_t>(i >> 32),
+                                                      static_cast<std::uint32_t>(d), static_cast<std::uint32_t>(r)};
+                    std::uint32_t bits[4];
+                    philox4x32(counter, key, bits);
+                    u[d] = uniformDouble(bits[0], bits[1]);
+                    if (d + 1 < dims)
+                        u[d + 1] = uniformDouble(bits[2], bits[3]);
+                }
+                break;
+
+            case mc_sequence::halton:
+                for (std::size_t d = 0; d < dims; d++)
+                {
+                    const double v = radicalInverse(i + 1, haltonBase(d)) + shifts[r * dims + d];
+                    u[d] = v >= 1 ? v - 1 : v;
+                }
+                break;
+
+            case mc_sequence::sobol:
+                if (i != b)
+                    sobol.next(i, s);
+                for (std::size_t d = 0; d < dims; d++)
+                {
+                    u[d] = ((s[d] ^ digitalShifts[r * dims + d]) + 0.5) * 0x1p-32;
+                }
+                break;
+            }
+
+            for (std::size_t d = 0; d < dims; d++)
+            {
+                x[d] = lower[d] + (upper[d] - lower[d]) * u[d];
+            }
+            sum += f(static_cast<const double*>(x));
+        }
+
+        blocks[item].value = sum;
+    };
+
+#pragma omp parallel // Начало параллельной секции
+    {
+        std::size_t t = omp_get_thread_num(); // Номер текущего потока
+        std::size_t T = omp_get_num_threads(); // Общее количество потоков
+
+        // Непрерывная группа блоков текущего потока
+        auto [kb, ke] = blockRange(totalBlocks, T, t);
+        for (std::size_t k = kb; k < ke; k++)
+        {
+            sumBlock(k);
+        }
+    }
+
+    // Значение каждого набора - попарная сумма его блоков, затем среднее и дисперсия по наборам
+    std::vector<double> estimates(replicates);
+    double mean = 0;
+    for (std::size_t r = 0; r < replicates; r++)
+    {
+        estimates[r] = volume * pairwiseSum(blocks.data() + r * blocksPer, blocksPer) / m;
+        mean += estimates[r];
+    }
+    mean /= replicates;
+
+    double variance = 0;
+    for (double estimate : estimates)
+    {
+        variance += (estimate - mean) * (estimate - mean);
+    }
+    variance /= replicates - 1;
+
+    return mc_result{mean, variance, std::sqrt(variance / replicates), m * replicates};
+}
@@ -0,0 +1,134 @@
+/* Отображение файла значений в память и параллельное интегрирование по нему.
+    * MappedSamples - mmap только для чтения с подсказкой MADV_SEQUENTIAL.
+    * integrateSamples - формулы трапеций и Симпсона по блокам файла (OpenMP). */
+
+#include "tabulated.h"
+#include "integrate.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedSamples::MappedSamples(const std::string& path, sample_type type) : type_(type)
+{
+    fd_ = open(path.c_str(), O_RDONLY);
+    if (fd_ < 0)
+        throw std::runtime_error("Couldn't open file " + path + ": " + std::strerror(errno));
+
+    struct stat info;
+    if (fstat(fd_, &info) != 0 || info.st_size < static_cast<off_t>(2 * sampleSize()))
+    {
+        close(fd_);
+        throw std::runtime_error("File " + path + " has fewer than two samples");
+    }
+    bytes_ = static_cast<std::size_t>(info.st_size) / sampleSize() * sampleSize();
+
+    data_ = mmap(nullptr, bytes_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (data_ == MAP_FAILED)
+    {
+        close(fd_);
+        throw std::runtime_error("Couldn't map file " + path + ": " + std::strerror(errno));
+    }
+
+    madvise(data_, bytes_, MADV_SEQUENTIAL); // Файл читается подряд - включаем упреждающее чтение
+}
+
+MappedSamples::~MappedSamples()
+{
+    munmap(data_, bytes_);
+    close(fd_);
+}
+
+void MappedSamples::release(std::size_t begin, std::size_t end) const
+{
+    const std::size_t page = sysconf(_SC_PAGESIZE);
+    const std::size_t first = (begin * sampleSize() + page - 1) / page * page; // Вверх до страницы
+    const std::size_t last = end * sampleSize() / page * page;                 // Вниз до страницы
+    if (first < last)
+        madvise(static_cast<char*>(data_) + first, last - first, MADV_DONTNEED);
+}
+
+namespace
+{
+    // Суммы значений [b, e): по всем точкам и по точкам с нечётными номерами
+    template <class Sample>
+    void sumSamples(const Sample* y, std::size_t b, std::size_t e, double& all, double& odd)
+    {
+        double evenSum = 0, oddSum = 0;
+        std::size_t i = b;
+        if (i < e && i % 2 == 1)
+        {
+            oddSum += y[i++];
+        }
+
+#pragma omp simd reduction(+ : evenSum, oddSum)
+        for (std::size_t j = i; j < e - (e - i) % 2; j += 2)
+        {
+            evenSum += y[j];
+            oddSum += y[j + 1];
+        }
+
+        if ((e - i) % 2 == 1)
+        {
+            evenSum += y[e - 1];
+        }
+
+        all = evenSum + oddSum;
+        odd = oddSum;
+    }
+
+    template <class Sample>
+    double integrateTyped(const MappedSamples& samples, double a, double b, tabulated_rule rule)
+    {
+        const Sample* y = samples.data<Sample>();
+        const std::size_t n = samples.size();
+        const double h = (b - a) / (n - 1); // Шаг сетки
+
+        // Симпсон требует нечётного количества точек (не меньше трёх); при чётном последний отрезок
+        // считается по трапеции
+        const bool simpson = rule == tabulated_rule::simpson && n >= 3;
+        const std::size_t m = (simpson && n % 2 == 0) ? n - 1 : n;
+
+        std::vector<partial_sum_t> allSums(integrate_blocks), oddSums(integrate_blocks);
+
+#pragma omp parallel // Начало параллельной секции
+        {
+            std::size_t t = omp_get_thread_num(); // Номер текущего потока
+            std::size_t T = omp_get_num_threads(); // Общее количество потоков
+
+            auto [kb, ke] = blockRange(integrate_blocks, T, t);
+            for (std::size_t k = kb; k < ke; k++)
+            {
+                auto [begin, end] = blockRange(m, integrate_blocks, k);
+                sumSamples(y, begin, end, allSums[k].value, oddSums[k].value);
+                samples.release(begin, end); // Прочитанные страницы больше не нужны
+            }
+        }
+
+        const double all = pairwiseSum(allSums.data(), integrate_blocks);
+        const double odd = pairwiseSum(oddSums.data(), integrate_blocks);
+        const double y0 = y[0], ylast = y[m - 1];
+
+        if (!simpson)
+        {
+            return h * (all - 0.5 * (y0 + ylast));
+        }
+
+        // Веса Симпсона 1, 4, 2, 4, ..., 4, 1 = 2 * (все) + 2 * (нечётные) - крайние
+        double result = h / 3 * (2 * all + 2 * odd - y0 - ylast);
+        if (m != n)
+        {
+            result += 0.5 * h * (static_cast<double>(y[n - 2]) + y[n - 1]);
+        }
+        return result;
+    }
+}
+
+double integrateSamples(const MappedSamples& samples, double a, double b, tabulated_rule rule)
+{
+    if (samples.type() == sample_type::float32)
+        return integrateTyped<float>(samples, a, b, rule);
+    return integrateTyped<double>(samples, a, b, rule);
+}
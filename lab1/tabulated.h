@@ -0,0 +1,98 @@
+/* Интегрирование табличных данных из двоичного файла - основные моменты:
+    Файл содержит значения f(x) в равноотстоящих точках отрезка [a, b] подряд, как массив double или float.
+
+    Чтение без копирования:
+        Файл отображается в память (mmap) целиком, данные читаются прямо из отображения.
+        madvise(MADV_SEQUENTIAL) включает упреждающее чтение, а обработанные блоки сразу отдаются
+        обратно (MADV_DONTNEED), поэтому объём резидентной памяти не растёт вместе с размером файла.
+
+    Распараллеливание устроено как в integrateParallel: фиксированное число непрерывных блоков,
+    непрерывная группа блоков на поток, суммы блоков складываются попарным деревом.
+    Блок считает две суммы - по всем точкам и по точкам с нечётными номерами; из них собираются
+    формулы трапеций и Симпсона. */
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Тип значений в файле
+enum class sample_type
+{
+    float32,
+    float64
+};
+
+// Квадратурная формула
+enum class tabulated_rule
+{
+    trapezoid,
+    simpson // При чётном количестве точек последний отрезок считается по трапеции
+};
+
+// Файл значений, отображённый в память только для чтения
+class MappedSamples
+{
+public:
+    // При ошибке открытия или отображения бросает std::runtime_error
+    MappedSamples(const std::string& path, sample_type type);
+    ~MappedSamples();
+
+    MappedSamples(const MappedSamples&) = delete;
+    MappedSamples& operator=(const MappedSamples&) = delete;
+
+    std::size_t size() const { return bytes_ / sampleSize(); } // Количество значений
+    std::size_t bytes() const { return bytes_; }
+    sample_type type() const { return type_; }
+    std::size_t sampleSize() const { return type_ == sample_type::float32 ? sizeof(float) : sizeof(double); }
+
+    template <class T>
+    const T* data() const { return static_cast<const T*>(data_); }
+
+    // Освобождает страницы отображения, целиком лежащие в значениях [begin, end)
+    void release(std::size_t begin, std::size_t end) const;
+
+private:
+    int fd_ = -1;
+    void* data_ = nullptr;
+    std::size_t bytes_ = 0;
+    sample_type type_;
+};
+
+// Интеграл по значениям из файла, считая их заданными в равноотстоящих точках [a, b]
+double integrateSamples(const MappedSamples& samples, double a, double b, tabulated_rule rule);
+
+// Запись n значений f в равноотстоящих точках [a, b] в файл (порциями, без буфера на весь файл)
+template <class F>
+void writeSamples(const std::string& path, const F& f, double a, double b, std::size_t n, sample_type type)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Couldn't open file " + path);
+
+    const std::size_t portion = 1 << 20;
+    std::vector<double> values64(portion);
+    std::vector<float> values32(portion);
+    const double h = (b - a) / (n - 1);
+
+    for (std::size_t i = 0; i < n; i += portion)
+    {
+        const std::size_t count = std::min(portion, n - i);
+        for (std::size_t j = 0; j < count; j++)
+        {
+            values64[j] = f(a + (i + j) * h);
+            values32[j] = static_cast<float>(values64[j]);
+        }
+
+        if (type == sample_type::float64)
+            file.write(reinterpret_cast<const char*>(values64.data()), count * sizeof(double));
+        else
+            file.write(reinterpret_cast<const char*>(values32.data()), count * sizeof(float));
+    }
+
+    if (!file)
+        throw std::runtime_error("Couldn't write file " + path);
+}
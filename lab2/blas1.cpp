@@ -0,0 +1,335 @@
+/* Реализация операций BLAS первого уровня (OpenMP + AVX/AVX-512).
+    * vec - операции над регистром выбранной ширины (AVX-512 при -mavx512f, иначе AVX).
+    * forEachPart - непрерывная часть вектора на поток, sumParallel - редукция в четыре аккумулятора. */
+
+#include "blas1.h"
+#include <immintrin.h>
+#include <omp.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
+{
+#ifdef __AVX512F__
+    struct vec
+    {
+        using type = __m512d;
+        static constexpr std::size_t lanes = 8;
+        static __m512d zero() { return _mm512_setzero_pd(); }
+        static __m512d set1(double v) { return _mm512_set1_pd(v); }
+        static __m512d iota() { return _mm512_set_pd(7, 6, 5, 4, 3, 2, 1, 0); }
+        static __m512d load(const double* p) { return _mm512_loadu_pd(p); }
+        static void store(double* p, __m512d v) { _mm512_storeu_pd(p, v); }
+        static __m512d add(__m512d a, __m512d b) { return _mm512_add_pd(a, b); }
+        static __m512d mul(__m512d a, __m512d b) { return _mm512_mul_pd(a, b); }
+        static __m512d fmadd(__m512d a, __m512d b, __m512d c) { return _mm512_fmadd_pd(a, b, c); }
+        static __m512d abs(__m512d a) { return _mm512_abs_pd(a); }
+        static double hsum(__m512d a) { return _mm512_reduce_add_pd(a); }
+
+        // Для элементов a, больших текущего максимума m, запоминает значение и номер
+        static void keepMax(__m512d a, __m512d index, __m512d& m, __m512d& mIndex)
+        {
+            const __mmask8 greater = _mm512_cmp_pd_mask(a, m, _CMP_GT_OQ);
+            m = _mm512_mask_blend_pd(greater, m, a);
+            mIndex = _mm512_mask_blend_pd(greater, mIndex, index);
+        }
+    };
+#else
+    struct vec
+    {
+        using type = __m256d;
+        static constexpr std::size_t lanes = 4;
+        static __m256d zero() { return _mm256_setzero_pd(); }
+        static __m256d set1(double v) { return _mm256_set1_pd(v); }
+        static __m256d iota() { return _mm256_set_pd(3, 2, 1, 0); }
+        static __m256d load(const double* p) { return _mm256_loadu_pd(p); }
+        static void store(double* p, __m256d v) { _mm256_storeu_pd(p, v); }
+        static __m256d add(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+        static __m256d mul(__m256d a, __m256d b) { return _mm256_mul_pd(a, b); }
+        static __m256d fmadd(__m256d a, __m256d b, __m256d c)
+        {
+#ifdef __FMA__
+            return _mm256_fmadd_pd(a, b, c);
+#else
+            return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+        }
+        static __m256d abs(__m256d a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+        static double hsum(__m256d a)
+        {
+            __m128d s = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+            return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+        }
+
+        static void keepMax(__m256d a, __m256d index, __m256d& m, __m256d& mIndex)
+        {
+            const __m256d greater = _mm256_cmp_pd(a, m, _CMP_GT_OQ);
+            m = _mm256_blendv_pd(m, a, greater);
+            mIndex = _mm256_blendv_pd(mIndex, index, greater);
+        }
+    };
+#endif
+
+    // Частичный результат потока, по кэш-линии на поток
+    struct alignas(64) partial_t
+    {
+        double value;
+        std::size_t index;
+    };
+
+    // Элементы [b, e) части t из T
+    struct part_range
+    {
+        std::size_t b, e;
+    };
+
+    part_range part(std::size_t n, std::size_t T, std::size_t t)
+    {
+        return part_range{n * t / T, n * (t + 1) / T};
+    }
+
+    // Поэлементная операция: vop(i) - пакет с элемента i, sop(i) - один элемент
+    template <class VectorOp, class ScalarOp>
+    void forEachPart(std::size_t n, VectorOp vop, ScalarOp sop)
+    {
+#pragma omp parallel
+        {
+            auto [b, e] = part(n, omp_get_num_threads(), omp_get_thread_num());
+            const std::size_t full = b + (e - b) / vec::lanes * vec::lanes;
+
+            for (std::size_t i = b; i < full; i += vec::lanes)
+            {
+                vop(i);
+            }
+            for (std::size_t j = full; j < e; j++) // Хвост
+            {
+                sop(j);
+            }
+        }
+    }
+
+    // Параллельная сумма: vterm(acc, i) добавляет пакет с элемента i, sterm(s, i) - один элемент
+    template <class VectorTerm, class ScalarTerm>
+    double sumParallel(std::size_t n, VectorTerm vterm, ScalarTerm sterm)
+    {
+        std::vector<partial_t> partial(omp_get_max_threads());
+
+#pragma omp parallel
+        {
+            const std::size_t t = omp_get_thread_num();
+            auto [b, e] = part(n, omp_get_num_threads(), t);
+            const std::size_t step = 4 * vec::lanes;
+            const std::size_t full4 = b + (e - b) / step * step;
+            const std::size_t full = b + (e - b) / vec::lanes * vec::lanes;
+
+            // Четыре независимые цепочки сложений
+            vec::type acc0 = vec::zero(), acc1 = vec::zero(), acc2 = vec::zero(), acc3 = vec::zero();
+            for (std::size_t i = b; i < full4; i += step)
+            {
+                acc0 = vterm(acc0, i);
+                acc1 = vterm(acc1, i + vec::lanes);
+                acc2 = vterm(acc2, i + 2 * vec::lanes);
+                acc3 = vterm(acc3, i + 3 * vec::lanes);
+            }
+            for (std::size_t i = full4; i < full; i += vec::lanes)
+            {
+                acc0 = vterm(acc0, i);
+            }
+
+            double s = vec::hsum(vec::add(vec::add(acc0, acc1), vec::add(acc2, acc3)));
+            for (std::size_t j = full; j < e; j++) // Хвост
+            {
+                s = sterm(s, j);
+            }
+            partial[t].value = s;
+        }
+
+        double sum = 0;
+        for (const partial_t& p : partial)
+        {
+            sum += p.value;
+        }
+        return sum;
+    }
+
+    // Норма по сумме квадратов; при переполнении или потере точности - с масштабированием на maxAbs
+    template <class SumSquares, class MaxAbs>
+    double safeNorm(SumSquares sumSquares, MaxAbs maxAbs)
+    {
+        const double direct = sumSquares(1.0);
+        if (std::isfinite(direct) && direct >= std::numeric_limits<double>::min())
+            return std::sqrt(direct);
+
+        const double scale = maxAbs();
+        if (scale == 0 || !std::isfinite(scale))
+            return scale;
+        return scale * std::sqrt(sumSquares(1 / scale));
+    }
+}
+
+void axpy(std::size_t n, double alpha, const double* x, double* y)
+{
+    for (std::size_t i = 0; i < n; i++)
+    {
+        y[i] += alpha * x[i];
+    }
+}
+
+void axpySimd(std::size_t n, double alpha, const double* x, double* y)
+{
+    const vec::type a = vec::set1(alpha);
+    forEachPart(
+        n, [&](std::size_t i) { vec::store(y + i, vec::fmadd(a, vec::load(x + i), vec::load(y + i))); },
+        [&](std::size_t i) { y[i] += alpha * x[i]; });
+}
+
+void scal(std::size_t n, double alpha, double* x)
+{
+    for (std::size_t i = 0; i < n; i++)
+    {
+        x[i] *= alpha;
+    }
+}
+
+void scalSimd(std::size_t n, double alpha, double* x)
+{
+    const vec::type a = vec::set1(alpha);
+    forEachPart(
+        n, [&](std::size_t i) { vec::store(x + i, vec::mul(a, vec::load(x + i))); },
+        [&](std::size_t i) { x[i] *= alpha; });
+}
+
+double dot(std::size_t n, const double* x, const double* y)
+{
+    double sum = 0;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        sum += x[i] * y[i];
+    }
+    return sum;
+}
+
+double dotSimd(std::size_t n, const double* x, const double* y)
+{
+    return sumParallel(
+        n, [&](vec::type acc, std::size_t i) { return vec::fmadd(vec::load(x + i), vec::load(y + i), acc); },
+        [&](double s, std::size_t i) { return s + x[i] * y[i]; });
+}
+
+double nrm2(std::size_t n, const double* x)
+{
+    if (n == 0)
+        return 0; // Как в эталонном BLAS; иначе iamax(0, x) дал бы чтение x[0]
+
+    auto sumSquares = [&](double scale)
+    {
+        double sum = 0;
+        for (std::size_t i = 0; i < n; i++)
+        {
+            sum += (x[i] * scale) * (x[i] * scale);
+        }
+        return sum;
+    };
+    return safeNorm(sumSquares, [&] { return std::abs(x[iamax(n, x)]); });
+}
+
+double nrm2Simd(std::size_t n, const double* x)
+{
+    if (n == 0)
+        return 0; // Как в эталонном BLAS; иначе iamax(0, x) дал бы чтение x[0]
+
+    auto sumSquares = [&](double scale)
+    {
+        const vec::type s = vec::set1(scale);
+        return sumParallel(
+            n,
+            [&](vec::type acc, std::size_t i)
+            {
+                const vec::type v = vec::mul(vec::load(x + i), s);
+                return vec::fmadd(v, v, acc);
+            },
+            [&](double sum, std::size_t i) { return sum + (x[i] * scale) * (x[i] * scale); });
+    };
+    return safeNorm(sumSquares, [&] { return std::abs(x[iamaxSimd(n, x)]); });
+}
+
+double asum(std::size_t n, const double* x)
+{
+    double sum = 0;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        sum += std::abs(x[i]);
+    }
+    return sum;
+}
+
+double asumSimd(std::size_t n, const double* x)
+{
+    return sumParallel(
+        n, [&](vec::type acc, std::size_t i) { return vec::add(acc, vec::abs(vec::load(x + i))); },
+        [&](double s, std::size_t i) { return s + std::abs(x[i]); });
+}
+
+std::size_t iamax(std::size_t n, const double* x)
+{
+    std::size_t index = 0;
+    for (std::size_t i = 1; i < n; i++)
+    {
+        if (std::abs(x[i]) > std::abs(x[index]))
+            index = i;
+    }
+    return index;
+}
+
+std::size_t iamaxSimd(std::size_t n, const double* x)
+{
+    if (n == 0)
+        return 0;
+
+    std::vector<partial_t> partial(omp_get_max_threads(), partial_t{-1, 0});
+
+#pragma omp parallel
+    {
+        const std::size_t t = omp_get_thread_num();
+        auto [b, e] = part(n, omp_get_num_threads(), t);
+        const std::size_t full = b + (e - b) / vec::lanes * vec::lanes;
+
+        // Максимум модуля и номер (в double - точно до 2^53) отдельно по каждой дорожке регистра
+        vec::type m = vec::set1(-1), mIndex = vec::zero();
+        vec::type index = vec::add(vec::set1(static_cast<double>(b)), vec::iota());
+        const vec::type step = vec::set1(static_cast<double>(vec::lanes));
+        for (std::size_t i = b; i < full; i += vec::lanes)
+        {
+            vec::keepMax(vec::abs(vec::load(x + i)), index, m, mIndex);
+            index = vec::add(index, step);
+        }
+
+        // Среди дорожек - наибольшее значение, при равенстве - меньший номер
+        double values[vec::lanes], indices[vec::lanes];
+        vec::store(values, m);
+        vec::store(indices, mIndex);
+        partial_t best{-1, 0};
+        for (std::size_t k = 0; k < vec::lanes; k++)
+        {
+            const std::size_t i = static_cast<std::size_t>(indices[k]);
+            if (values[k] > best.value || (values[k] == best.value && i < best.index))
+                best = partial_t{values[k], i};
+        }
+        for (std::size_t j = full; j < e; j++) // Хвост
+        {
+            if (std::abs(x[j]) > best.value)
+                best = partial_t{std::abs(x[j]), j};
+        }
+        partial[t] = best;
+    }
+
+    // Части идут по возрастанию номеров, поэтому строгое сравнение сохраняет первый максимум
+    partial_t best = partial[0];
+    for (const partial_t& p : partial)
+    {
+        if (p.value > best.value)
+            best = p;
+    }
+    return best.index;
+}
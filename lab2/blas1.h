@@ -0,0 +1,41 @@
+/* Операции BLAS первого уровня над большими векторами double - основные моменты:
+    Операции:
+        * axpy  - y = alpha * x + y
+        * scal  - x = alpha * x
+        * dot   - скалярное произведение x и y
+        * nrm2  - евклидова норма x
+        * asum  - сумма модулей элементов x
+        * iamax - номер первого элемента с наибольшим модулем
+
+    У каждой операции два варианта: скалярный (для сравнения, как addMatrix) и *Simd.
+
+    Вариант Simd:
+        * Вектор делится на T непрерывных частей, по одной на поток OpenMP.
+        * Внутри части - регистры AVX-512 (8 double) или AVX2 (4 double).
+        * Редукции (dot, nrm2, asum) ведутся в четырёх независимых аккумуляторах, чтобы сложения
+          не ждали друг друга (задержка сложения - около 4 тактов).
+        * Частичные результаты потоков лежат в разных кэш-линиях и складываются после параллельной секции.
+        * nrm2 сначала считает сумму квадратов напрямую; если она переполнилась или обнулилась,
+          делается второй проход с масштабированием на наибольший модуль. */
+
+#pragma once
+#include <cstddef>
+
+void axpy(std::size_t n, double alpha, const double* x, double* y);
+void axpySimd(std::size_t n, double alpha, const double* x, double* y);
+
+void scal(std::size_t n, double alpha, double* x);
+void scalSimd(std::size_t n, double alpha, double* x);
+
+double dot(std::size_t n, const double* x, const double* y);
+double dotSimd(std::size_t n, const double* x, const double* y);
+
+double nrm2(std::size_t n, const double* x);
+double nrm2Simd(std::size_t n, const double* x);
+
+double asum(std::size_t n, const double* x);
+double asumSimd(std::size_t n, const double* x);
+
+// Для n == 0 возвращает 0
+std::size_t iamax(std::size_t n, const double* x);
+std::size_t iamaxSimd(std::size_t n, const double* x);
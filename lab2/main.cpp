@@ -2,7 +2,7 @@
 Размеры матриц:
     Матрицы имеют размеры 32768 x 32768 (2^15 x 2^15).
 
-    Скалярное сложение (addMatrix):
+    Скалярное сложение (addMatrix, шаблон из simd_add.h):
         Проходит по всем элементам матриц и складывает их поэлементно.
         Используется для сравнения производительности с векторным сложением.
 
@@ -18,9 +18,37 @@
     Инициализация матриц:
         Матрица B заполнена единицами, матрица C — минус двойками.
         Матрица A используется для хранения результата.
+        Матрицы хранятся в AlignedMatrix (common/aligned_matrix.h): строки выровнены на 64 байта,
+        память на больших страницах и не обнуляется при выделении. Поэтому ядра используют
+        выровненные _mm256_load_pd/_mm256_store_pd.
 
     Очистка матриц:
-        Перед векторным сложением матрицы A, B и C очищаются и заполняются новыми значениями. */
+        Перед векторным сложением матрицы A, B и C очищаются и заполняются новыми значениями.
+
+    Режим parallel (./lab2 parallel):
+        Многопоточное сложение addMatrixParallel (parallel_add.h) с размещением страниц по first touch
+        и потоковой записью результата. Время и ГБ/с для каждого количества потоков - в output_parallel.csv.
+
+    Режим fused (./lab2 fused):
+        Цепочка A = (B + C) * k - D по шагам (три прохода по памяти) и через шаблоны выражений
+        (matrix_expr.h) - одним проходом без временных матриц. Время и ГБ/с - в output_fused.csv.
+
+    Режим stream (./lab2 stream [--rows=N]):
+        Сложение матриц из файлов ../stream_B.bin и ../stream_C.bin в ../stream_A.bin (stream_add.h)
+        по тайлам разного размера без загрузки матриц в память целиком. Время, ГБ/с и пиковый объём
+        резидентной памяти - в output_stream.csv. Файлы входных матриц создаются при первом запуске.
+
+    Режим types (./lab2 types [--rows=N]):
+        Скалярное и векторное сложение (simd_add.h) для double, float, int32, int64 и bfloat16.
+        Ширина пакета выбирается по типу на этапе компиляции. Время и ГБ/с - в output_types.csv.
+
+    Режим blas (./lab2 blas [--rows=N]):
+        Операции BLAS первого уровня (blas1.h: axpy, scal, dot, nrm2, asum, iamax) над векторами
+        из cols * N элементов, скалярно и многопоточно с AVX. Время и ГБ/с - в output_blas.csv.
+
+    Режим view (./lab2 view [--rows=N]):
+        Сложение окна 4096 x 4096 внутри больших матриц: через MatrixView (matrix_view.h) на месте
+        и через копирование окна в плотные буферы и обратно. Время - в output_view.csv. */
 
 
 #include <algorithm>
@@ -30,6 +58,22 @@
 #include <immintrin.h>
 #include <fstream>
 #include <cstring> // Для memset (очистки кэша)
+#include <string>
+#include <thread>
+#include <omp.h>
+#include "parallel_add.h"
+#include "../common/aligned_matrix.h"
+#include "simd_add.h"
+#include "blas1.h"
+#include "matrix_view.h"
+#include <cmath>
+#include <functional>
+#include "matrix_expr.h"
+#include "stream_add.h"
+#include <filesystem>
+#include <charconv>
+#include <limits>
+#include <stdexcept>
 
 const int cols = 1 << 15; // Количество столбцов (32768)
 const int rows = 1 << 15; // Количество строк (32768)
@@ -44,15 +88,6 @@ void clear_cache() {
     delete[] memory; // Освобождаем память
 }
 
-// Скалярное сложение матриц
-void addMatrix(double* A, const double* B, const double* C, size_t colsc, size_t rowsc)
-{
-    for (size_t i = 0; i < colsc * rowsc; i++)
-    {
-        A[i] = B[i] + C[i];
-    }
-}
-
 // Векторное сложение матриц с использованием AVX
 void addMatrix256(double* A, const double* B, const double* C, size_t colsc, size_t rowsc)
 {
@@ -65,8 +100,538 @@ void addMatrix256(double* A, const double* B, const double* C, size_t colsc, siz
     }
 }
 
-int main()
+// Векторное сложение выровненных матриц: строки начинаются на границе 64 байт, загрузки выровненные
+void addMatrix256(AlignedMatrix<double>& A, const AlignedMatrix<double>& B, const AlignedMatrix<double>& C)
+{
+    for (size_t r = 0; r < A.rows(); r++)
+    {
+        double* a = A.row(r);
+        const double* b = B.row(r);
+        const double* c = C.row(r);
+
+        size_t i = 0;
+        for (; i + batch <= A.cols(); i += batch)
+        {
+            _mm256_store_pd(a + i, _mm256_add_pd(_mm256_load_pd(b + i), _mm256_load_pd(c + i)));
+        }
+
+        for (; i < A.cols(); i++) // Хвост строки
+        {
+            a[i] = b[i] + c[i];
+        }
+    }
+}
+
+// Векторное сложение окон матриц: строка за строкой, в каждой пакеты по 4 и хвост
+void addMatrix256(MatrixView<double> A, MatrixView<const double> B, MatrixView<const double> C)
+{
+    if (A.contiguous() && B.contiguous() && C.contiguous() && A.cols * A.rows % batch == 0)
+    {
+        addMatrix256(A.data, B.data, C.data, A.cols, A.rows);
+        return;
+    }
+
+    for (size_t r = 0; r < A.rows; r++)
+    {
+        double* a = A.row(r);
+        const double* b = B.row(r);
+        const double* c = C.row(r);
+
+        size_t i = 0;
+        for (; i + batch <= A.cols; i += batch)
+        {
+            _mm256_storeu_pd(a + i, _mm256_add_pd(_mm256_loadu_pd(b + i), _mm256_loadu_pd(c + i)));
+        }
+
+        for (; i < A.cols; i++) // Хвост строки
+        {
+            a[i] = b[i] + c[i];
+        }
+    }
+}
+
+// Режим "parallel": многопоточное сложение с разным количеством потоков,
+// результаты (время и пропускная способность) записываются в output_parallel.csv
+int parallelMain()
+{
+    std::ofstream output("../output_parallel.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    const size_t threadCount = std::thread::hardware_concurrency();
+    const double bytes = 3.0 * cols * rows * sizeof(double); // Чтение B и C, запись A
+
+    std::cout << "LLC size: " << (lastLevelCacheSize() >> 20) << " MB\n";
+    std::cout << "T\t| Duration, ms\t| GB/s\n";
+    output << "T,Duration,GBps\n";
+
+    for (size_t T = 1; T <= threadCount; T++)
+    {
+        omp_set_num_threads(T);
+
+        // Матрицы выделяются заново для каждого T, чтобы страницы легли на узлы именно этих потоков
+        auto B = allocateMatrix(cols, rows), C = allocateMatrix(cols, rows), A = allocateMatrix(cols, rows);
+        fillMatrixParallel(B.get(), 1, cols, rows);
+        fillMatrixParallel(C.get(), -2, cols, rows);
+        fillMatrixParallel(A.get(), 0, cols, rows);
+
+        double total_time = 0;
+        for (int test = 0; test < num_tests; ++test)
+        {
+            clear_cache();
+            auto t1 = std::chrono::steady_clock::now();
+            addMatrixParallel(A.get(), B.get(), C.get(), cols, rows);
+            auto t2 = std::chrono::steady_clock::now();
+            total_time += std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+        }
+
+        double avg_time = total_time / num_tests;
+        std::cout << T << "\t| " << avg_time << "\t\t| " << bytes / avg_time / 1e6 << "\n";
+        output << T << "," << avg_time << "," << bytes / avg_time / 1e6 << "\n";
+    }
+
+    output.close();
+    return 0;
+}
+
+// Режим "fused": цепочка из трёх поэлементных операций по шагам и одним слитым проходом,
+// результаты записываются в output_fused.csv
+int fusedMain()
+{
+    std::ofstream output("../output_fused.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    const size_t fusedRows = rows / 2; // Четыре матрицы вместо трёх - уменьшаем размер, чтобы уложиться в память
+    const double k = 0.5;
+    const double matrix = 1.0 * cols * fusedRows * sizeof(double);
+
+    auto B = allocateMatrix(cols, fusedRows), C = allocateMatrix(cols, fusedRows);
+    auto D = allocateMatrix(cols, fusedRows), A = allocateMatrix(cols, fusedRows);
+    fillMatrixParallel(B.get(), 1, cols, fusedRows);
+    fillMatrixParallel(C.get(), -2, cols, fusedRows);
+    fillMatrixParallel(D.get(), 3, cols, fusedRows);
+    fillMatrixParallel(A.get(), 0, cols, fusedRows);
+
+    expr::Matrix a = expr::lazy(A.get(), cols, fusedRows), b = expr::lazy(B.get(), cols, fusedRows);
+    expr::Matrix c = expr::lazy(C.get(), cols, fusedRows), d = expr::lazy(D.get(), cols, fusedRows);
+
+    double total_steps = 0, total_fused = 0;
+    for (int test = 0; test < num_tests; ++test)
+    {
+        // По шагам: каждая операция - отдельный проход (3 + 2 + 3 матрицы)
+        clear_cache();
+        auto t1 = std::chrono::steady_clock::now();
+        a = b + c;
+        a = a * k;
+        a = a - d;
+        auto t2 = std::chrono::steady_clock::now();
+        total_steps += std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+
+        // Одним проходом: чтение B, C, D и запись A
+        clear_cache();
+        t1 = std::chrono::steady_clock::now();
+        a = (b + c) * k - d;
+        t2 = std::chrono::steady_clock::now();
+        total_fused += std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+    }
+
+    if (A[0] != (1 - 2) * k - 3)
+    {
+        std::cout << "Wrong result: " << A[0] << "\n";
+        return -1;
+    }
+
+    const double avg_steps = total_steps / num_tests, avg_fused = total_fused / num_tests;
+    const double bytes_steps = 8 * matrix, bytes_fused = 4 * matrix;
+
+    std::cout << "Mode\t| Duration, ms\t| GB moved\t| GB/s\n";
+    std::cout << "steps\t| " << avg_steps << "\t\t| " << bytes_steps / 1e9 << "\t\t| " << bytes_steps / avg_steps / 1e6 << "\n";
+    std::cout << "fused\t| " << avg_fused << "\t\t| " << bytes_fused / 1e9 << "\t\t| " << bytes_fused / avg_fused / 1e6 << "\n";
+
+    output << "mode,Duration,GB,GBps\n";
+    output << "steps," << avg_steps << "," << bytes_steps / 1e9 << "," << bytes_steps / avg_steps / 1e6 << "\n";
+    output << "fused," << avg_fused << "," << bytes_fused / 1e9 << "," << bytes_fused / avg_fused / 1e6 << "\n";
+
+    output.close();
+    return 0;
+}
+
+// Режим "stream": сложение матриц из файлов по тайлам разного размера,
+// результаты (время, пропускная способность, пиковая память) записываются в output_stream.csv
+int streamMain(size_t rowsc)
+{
+    std::ofstream output("../output_stream.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    const std::string pathA = "../stream_A.bin", pathB = "../stream_B.bin", pathC = "../stream_C.bin";
+    const size_t bytes = cols * rowsc * sizeof(double);
+    const size_t tileSizes[] = {4, 16, 64, 256}; // Размеры тайлов, МБ
+
+    try
+    {
+        // Входные файлы создаются один раз: их запись дольше самого сложения
+        for (const auto& [path, value] : {std::pair{pathB, 1.0}, std::pair{pathC, -2.0}})
+        {
+            std::error_code error;
+            if (std::filesystem::file_size(path, error) != bytes)
+            {
+                std::cout << "Writing " << path << "\n";
+                writeMatrixFile(path, value, cols, rowsc);
+            }
+        }
+
+        MappedMatrix B(pathB, cols, rowsc, map_mode::read), C(pathC, cols, rowsc, map_mode::read);
+        MappedMatrix A(pathA, cols, rowsc, map_mode::write);
+
+        std::cout << "Tile, MB\t| Duration, ms\t| GB/s\t| Peak RSS, MB\n";
+        output << "Tile,Duration,GBps,PeakRSS\n";
+
+        for (size_t tile : tileSizes)
+        {
+            const size_t tileRows = std::max<size_t>(1, (tile << 20) / (cols * sizeof(double)));
+
+            double total_time = 0;
+            size_t peak = 0;
+            for (int test = 0; test < num_tests; ++test)
+            {
+                // Аналог clear_cache: входные файлы убираются из страничного кэша, чтобы читаться с диска
+                B.release(0, B.size());
+                C.release(0, C.size());
+                resetPeakResident();
+
+                auto t1 = std::chrono::steady_clock::now();
+                streamAddMatrix(A, B, C, tileRows);
+                auto t2 = std::chrono::steady_clock::now();
+                total_time += std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+                peak = std::max(peak, peakResidentBytes());
+            }
+
+            if (A.data()[0] != -1 || A.data()[A.size() - 1] != -1)
+            {
+                std::cout << "Wrong result!\n";
+                return -1;
+            }
+            A.release(0, A.size());
+
+            double avg_time = total_time / num_tests;
+            double speed = 3.0 * bytes / avg_time / 1e6; // Чтение B и C, запись A
+            std::cout << tile << "\t\t| " << avg_time << "\t\t| " << speed << "\t| " << (peak >> 20) << "\n";
+            output << tile << "," << avg_time << "," << speed << "," << (peak >> 20) << "\n";
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << e.what() << "\n";
+        return -1;
+    }
+
+    output.close();
+    return 0;
+}
+
+// Сложение матриц типа T скалярно и пакетами, одна строка в output_types.csv
+template <class T>
+bool typeTest(const char* name, size_t rowsc, std::ofstream& output)
+{
+    AlignedMatrix<T> B(cols, rowsc), C(cols, rowsc), A(cols, rowsc);
+    const double bytes = 3.0 * cols * rowsc * sizeof(T); // Чтение B и C, запись A
+
+    double total_scalar_time = 0, total_vector_time = 0;
+    for (int test = 0; test < num_tests; ++test)
+    {
+        B.fill(T(1));
+        C.fill(T(2));
+        A.fill(T(0));
+        clear_cache();
+        auto t1 = std::chrono::steady_clock::now();
+        addMatrix(A, B, C);
+        auto t2 = std::chrono::steady_clock::now();
+        total_scalar_time += std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+
+        A.fill(T(0));
+        clear_cache();
+        t1 = std::chrono::steady_clock::now();
+        addMatrixSimd(A, B, C);
+        t2 = std::chrono::steady_clock::now();
+        total_vector_time += std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+    }
+
+    if (static_cast<double>(A(0, 0)) != 3 || static_cast<double>(A(rowsc - 1, cols - 1)) != 3)
+    {
+        std::cout << "Wrong result for " << name << "!\n";
+        return false;
+    }
+
+    const double avg_scalar_time = total_scalar_time / num_tests, avg_vector_time = total_vector_time / num_tests;
+    const size_t lanes = simd_element<T>::lanes;
+    std::cout << name << "\t| " << lanes << "\t| " << avg_scalar_time << "\t\t| " << avg_vector_time << "\t\t| "
+              << bytes / avg_vector_time / 1e6 << "\n";
+    output << name << "," << lanes << "," << avg_scalar_time << "," << avg_vector_time << ","
+           << bytes / avg_scalar_time / 1e6 << "," << bytes / avg_vector_time / 1e6 << "\n";
+    return true;
+}
+
+// Режим "types": сложение для разных типов элементов, результаты записываются в output_types.csv
+int typesMain(size_t rowsc)
+{
+    std::ofstream output("../output_types.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    std::cout << "Type\t| Lanes\t| Scalar, ms\t| Vector, ms\t| Vector GB/s\n";
+    output << "type,lanes,scalar,vector,GBps_scalar,GBps_vector\n";
+
+    const bool ok = typeTest<double>("double", rowsc, output) && typeTest<float>("float", rowsc, output) &&
+                    typeTest<std::int32_t>("int32", rowsc, output) && typeTest<std::int64_t>("int64", rowsc, output) &&
+                    typeTest<bfloat16>("bfloat16", rowsc, output);
+
+    output.close();
+    return ok ? 0 : -1;
+}
+
+// Режим "blas": скалярные и векторные операции BLAS первого уровня,
+// результаты (время и пропускная способность) записываются в output_blas.csv
+int blasMain(size_t rowsc)
 {
+    const size_t n = cols * rowsc;
+    if (n < 4) // Наибольший элемент для iamax ставится в x[n / 2 + 3]
+    {
+        std::cout << "Vectors must have at least 4 elements\n";
+        return -1;
+    }
+
+    std::ofstream output("../output_blas.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    auto x = allocateMatrix(cols, rowsc), y = allocateMatrix(cols, rowsc);
+    fillMatrixParallel(x.get(), 1, cols, rowsc);
+    fillMatrixParallel(y.get(), -2, cols, rowsc);
+    x[n / 2 + 3] = -5; // Единственный наибольший по модулю элемент для iamax
+
+    std::cout << "Kernel\t| Scalar, ms\t| Vector, ms\t| Scalar GB/s\t| Vector GB/s\n";
+    output << "kernel,scalar,vector,GBps_scalar,GBps_vector\n";
+
+    // Время скалярного и векторного варианта; vectors - сколько векторов по n элементов читается и пишется
+    bool ok = true;
+    auto measure = [&](const char* name, double vectors, const std::function<double()>& scalar,
+                       const std::function<double()>& vector)
+    {
+        double total_scalar_time = 0, total_vector_time = 0;
+        double scalar_result = 0, vector_result = 0;
+        for (int test = 0; test < num_tests; ++test)
+        {
+            clear_cache();
+            auto t1 = std::chrono::steady_clock::now();
+            scalar_result = scalar();
+            auto t2 = std::chrono::steady_clock::now();
+            total_scalar_time += std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+
+            clear_cache();
+            t1 = std::chrono::steady_clock::now();
+            vector_result = vector();
+            t2 = std::chrono::steady_clock::now();
+            total_vector_time += std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+        }
+
+        if (std::abs(scalar_result - vector_result) > 1e-9 * std::abs(scalar_result))
+        {
+            std::cout << name << ": results differ (" << scalar_result << " vs " << vector_result << ")\n";
+            ok = false;
+        }
+
+        const double bytes = vectors * n * sizeof(double);
+        const double avg_scalar_time = total_scalar_time / num_tests, avg_vector_time = total_vector_time / num_tests;
+        std::cout << name << "\t| " << avg_scalar_time << "\t\t| " << avg_vector_time << "\t\t| "
+                  << bytes / avg_scalar_time / 1e6 << "\t\t| " << bytes / avg_vector_time / 1e6 << "\n";
+        output << name << "," << avg_scalar_time << "," << avg_vector_time << "," << bytes / avg_scalar_time / 1e6
+               << "," << bytes / avg_vector_time / 1e6 << "\n";
+    };
+
+    // axpy и scal меняют y и x: чередование знака alpha возвращает данные к исходным значениям
+    measure("axpy", 3, [&] { axpy(n, 0.5, x.get(), y.get()); return y[0]; },
+            [&] { axpySimd(n, -0.5, x.get(), y.get()); return y[0] + 0.5 * x[0]; });
+    measure("scal", 2, [&] { scal(n, 2, y.get()); return y[0]; },
+            [&] { scalSimd(n, 0.5, y.get()); return y[0] * 2; });
+    measure("dot", 2, [&] { return dot(n, x.get(), y.get()); }, [&] { return dotSimd(n, x.get(), y.get()); });
+    measure("nrm2", 1, [&] { return nrm2(n, x.get()); }, [&] { return nrm2Simd(n, x.get()); });
+    measure("asum", 1, [&] { return asum(n, x.get()); }, [&] { return asumSimd(n, x.get()); });
+    measure("iamax", 1, [&] { return double(iamax(n, x.get())); }, [&] { return double(iamaxSimd(n, x.get())); });
+
+    output.close();
+    return ok ? 0 : -1;
+}
+
+// Режим "view": сложение окна матриц на месте и через копирование,
+// результаты записываются в output_view.csv
+int viewMain(size_t rowsc)
+{
+    if (rowsc == 0) // Окно не может быть пустым
+    {
+        std::cout << "Rows must be at least 1\n";
+        return -1;
+    }
+
+    std::ofstream output("../output_view.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    const size_t window = std::min<size_t>(4096, rowsc); // Размер окна
+    const size_t r0 = (rowsc - window) / 2, c0 = (cols - window) / 2; // Окно в середине матрицы
+
+    auto B = allocateMatrix(cols, rowsc), C = allocateMatrix(cols, rowsc), A = allocateMatrix(cols, rowsc);
+    fillMatrixParallel(B.get(), 1, cols, rowsc);
+    fillMatrixParallel(C.get(), -2, cols, rowsc);
+    fillMatrixParallel(A.get(), 0, cols, rowsc);
+
+    auto wA = denseView(A.get(), cols, rowsc).sub(r0, c0, window, window);
+    auto wB = denseView<const double>(B.get(), cols, rowsc).sub(r0, c0, window, window);
+    auto wC = denseView<const double>(C.get(), cols, rowsc).sub(r0, c0, window, window);
+
+    // Плотные буферы для варианта с копированием
+    auto bufB = allocateMatrix(window, window), bufC = allocateMatrix(window, window);
+    auto bufA = allocateMatrix(window, window);
+    auto copyOut = [&](MatrixView<const double> from, double* to)
+    {
+        for (size_t r = 0; r < window; r++)
+        {
+            std::memcpy(to + r * window, from.row(r), window * sizeof(double));
+        }
+    };
+
+    std::cout << "Kernel\t\t| Copy, ms\t| View, ms\n";
+    output << "kernel,copy,view\n";
+
+    // Время одного ядра на окне: с копированием окна туда и обратно и прямо через MatrixView
+    auto measure = [&](const char* name, auto kernel)
+    {
+        double total_copy_time = 0, total_view_time = 0;
+        for (int test = 0; test < num_tests; ++test)
+        {
+            clear_cache();
+            auto t1 = std::chrono::steady_clock::now();
+            copyOut(wB, bufB.get());
+            copyOut(wC, bufC.get());
+            kernel(denseView(bufA.get(), window, window), denseView<const double>(bufB.get(), window, window),
+                   denseView<const double>(bufC.get(), window, window));
+            for (size_t r = 0; r < window; r++)
+            {
+                std::memcpy(wA.row(r), bufA.get() + r * window, window * sizeof(double));
+            }
+            auto t2 = std::chrono::steady_clock::now();
+            total_copy_time += std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+
+            clear_cache();
+            t1 = std::chrono::steady_clock::now();
+            kernel(wA, wB, wC);
+            t2 = std::chrono::steady_clock::now();
+            total_view_time += std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+        }
+
+        std::cout << name << "\t| " << total_copy_time / num_tests << "\t\t| " << total_view_time / num_tests << "\n";
+        output << name << "," << total_copy_time / num_tests << "," << total_view_time / num_tests << "\n";
+    };
+
+    using view = MatrixView<double>;
+    using cview = MatrixView<const double>;
+    measure("addMatrix", [](view a, cview b, cview c) { addMatrix(a, b, c); });
+    measure("addMatrix256", [](view a, cview b, cview c) { addMatrix256(a, b, c); });
+    measure("addMatrixSimd", [](view a, cview b, cview c) { addMatrixSimd(a, b, c); });
+    measure("addMatrixParallel", [](view a, cview b, cview c) { addMatrixParallel(a, b, c); });
+    measure("expression", [](view a, cview b, cview c) { expr::lazy(a) = expr::lazy(b) + expr::lazy(c); });
+
+    // Окно A = -1, вне окна A не тронут
+    const bool ok = wA(0, 0) == -1 && wA(window - 1, window - 1) == -1 && (c0 == 0 || A[r0 * cols + c0 - 1] == 0);
+    if (!ok)
+        std::cout << "Wrong result!\n";
+
+    output.close();
+    return ok ? 0 : -1;
+}
+
+// Необязательный параметр --rows=N (количество строк матриц); без него rowsc не меняется.
+// false - значение не число или вне допустимого диапазона (сообщение уже выведено)
+bool rowsOption(int argc, char** argv, size_t& rowsc)
+{
+    const size_t max_rows = std::numeric_limits<size_t>::max() / (cols * sizeof(double)); // Без переполнения байт
+    for (int i = 2; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (arg.rfind("--rows=", 0) == 0)
+        {
+            const char* first = arg.data() + 7;
+            const char* last = arg.data() + arg.size();
+            auto [ptr, error] = std::from_chars(first, last, rowsc);
+            if (error != std::errc() || ptr != last || rowsc == 0 || rowsc > max_rows)
+            {
+                std::cout << "Rows must be in [1, " << max_rows << "]\n";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    // Режим работы задаётся первым аргументом, без аргументов - сравнение скалярного и векторного сложения
+    const std::string mode = argc > 1 ? argv[1] : "";
+    if (mode == "parallel")
+    {
+        return parallelMain();
+    }
+    if (mode == "fused")
+    {
+        return fusedMain();
+    }
+    if (mode == "stream")
+    {
+        // Необязательный --rows=N уменьшает матрицы (по умолчанию 32768 строк, 8 ГиБ на файл)
+        size_t rowsc = rows;
+        return rowsOption(argc, argv, rowsc) ? streamMain(rowsc) : -1;
+    }
+    if (mode == "types")
+    {
+        size_t rowsc = rows / 4; // Три матрицы double по 2 ГиБ
+        return rowsOption(argc, argv, rowsc) ? typesMain(rowsc) : -1;
+    }
+    if (mode == "blas")
+    {
+        size_t rowsc = rows / 4; // Два вектора по 2 ГиБ
+        return rowsOption(argc, argv, rowsc) ? blasMain(rowsc) : -1;
+    }
+    if (mode == "view")
+    {
+        size_t rowsc = rows / 4; // Три матрицы по 2 ГиБ
+        return rowsOption(argc, argv, rowsc) ? viewMain(rowsc) : -1;
+    }
+
     std::ofstream output("../output.csv");
 
     if (!output.is_open())
@@ -78,7 +643,8 @@ int main()
     // Заголовок для CSV-файла
     output << "test,scalar,vector,avg_scalar,avg_vector\n";
 
-    std::vector<double> B(cols * rows, 1), C(cols * rows, -2), A(cols * rows);
+    AlignedMatrix<double> B(cols, rows), C(cols, rows), A(cols, rows);
+    std::cout << "Huge pages (MAP_HUGETLB): " << (A.hugePages() ? "yes" : "no, transparent") << "\n";
 
     double total_scalar_time = 0;
     double total_vector_time = 0;
@@ -93,13 +659,13 @@ int main()
         clear_cache();
 
         // Перезаполнение матриц
-        std::fill(B.begin(), B.end(), 1);
-        std::fill(C.begin(), C.end(), -2);
-        std::fill(A.begin(), A.end(), 0);
+        B.fill(1);
+        C.fill(-2);
+        A.fill(0);
 
         // Скалярное сложение
         auto t1 = std::chrono::steady_clock::now();
-        addMatrix(A.data(), B.data(), C.data(), cols, rows);
+        addMatrix(A, B, C);
         auto t2 = std::chrono::steady_clock::now();
         double scalar_time = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
         scalar_times[test] = scalar_time;
@@ -109,13 +675,13 @@ int main()
         clear_cache();
 
         // Перезаполнение матриц
-        std::fill(B.begin(), B.end(), -2);
-        std::fill(C.begin(), C.end(), 1);
-        std::fill(A.begin(), A.end(), 0);
+        B.fill(-2);
+        C.fill(1);
+        A.fill(0);
 
         // Векторное сложение
         t1 = std::chrono::steady_clock::now();
-        addMatrix256(A.data(), B.data(), C.data(), cols, rows);
+        addMatrix256(A, B, C);
         t2 = std::chrono::steady_clock::now();
         double vector_time = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
         vector_times[test] = vector_time;
@@ -0,0 +1,246 @@
+/* Шаблоны выражений для поэлементных операций над матрицами - основные моменты:
+    Ленивое вычисление:
+        Выражение вида (B + C) * k - D не считается по шагам. Операторы строят на этапе компиляции
+        дерево типов (Binary<Sub, Binary<Mul, Binary<Add, Ref, Ref>, Scalar>, Ref>), а вычисление
+        происходит только при присваивании в матрицу - за один проход по памяти, без временных матриц.
+
+    Один проход:
+        Для каждого пакета из 4 элементов дерево разворачивается компилятором в цепочку AVX-инструкций:
+        каждый вход читается один раз, результат пишется один раз. Цепочка из трёх операций вместо трёх
+        проходов по 8 ГиБ делает один.
+
+    Операции: +, -, умножение на скаляр и поэлементное *, fma(a, b, c) = a * b + c, min, max.
+    Левая часть может входить в правую (A = A * k - D): элемент читается до того, как перезаписывается.
+
+    Окна матриц:
+        Листья хранят ведущую размерность ld, поэтому в выражениях участвуют и окна (MatrixView).
+        Если все матрицы выражения непрерывны, оно считается одним проходом по плотному массиву,
+        иначе - по строкам: row(r) сдвигает каждый лист дерева на начало строки r. */
+
+#pragma once
+#include <immintrin.h>
+#include <omp.h>
+#include <cstddef>
+#include <type_traits>
+#include "matrix_view.h"
+
+namespace expr
+{
+    constexpr std::size_t batch = 4; // Размер пакета для AVX (4 double)
+
+    // Базовый класс-метка: только такие типы участвуют в операторах ниже
+    struct expression
+    {
+    };
+
+    template <class E>
+    concept matrix_expression = std::is_base_of_v<expression, E>;
+
+    // Лист дерева - матрица только для чтения с шагом строк ld
+    struct Ref : expression
+    {
+        const double* data;
+        std::size_t ld;
+
+        __m256d load(std::size_t i) const { return _mm256_loadu_pd(data + i); }
+        double at(std::size_t i) const { return data[i]; }
+        Ref row(std::size_t r) const { return Ref{{}, data + r * ld, ld}; }
+        bool dense(std::size_t cols) const { return ld == cols; }
+    };
+
+    // Лист дерева - скаляр, одинаковый для всех элементов
+    struct Scalar : expression
+    {
+        double value;
+
+        __m256d load(std::size_t) const { return _mm256_set1_pd(value); }
+        double at(std::size_t) const { return value; }
+        Scalar row(std::size_t) const { return *this; }
+        bool dense(std::size_t) const { return true; }
+    };
+
+    // Операции: векторная и скалярная версии
+    struct Add
+    {
+        static __m256d apply(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+        static double apply(double a, double b) { return a + b; }
+    };
+
+    struct Sub
+    {
+        static __m256d apply(__m256d a, __m256d b) { return _mm256_sub_pd(a, b); }
+        static double apply(double a, double b) { return a - b; }
+    };
+
+    struct Mul
+    {
+        static __m256d apply(__m256d a, __m256d b) { return _mm256_mul_pd(a, b); }
+        static double apply(double a, double b) { return a * b; }
+    };
+
+    // Скалярные min и max как _mm256_min_pd/_mm256_max_pd: если a или b - NaN, результат b
+    struct Min
+    {
+        static __m256d apply(__m256d a, __m256d b) { return _mm256_min_pd(a, b); }
+        static double apply(double a, double b) { return a < b ? a : b; }
+    };
+
+    struct Max
+    {
+        static __m256d apply(__m256d a, __m256d b) { return _mm256_max_pd(a, b); }
+        static double apply(double a, double b) { return a > b ? a : b; }
+    };
+
+    // Узел с двумя операндами
+    template <class Op, matrix_expression L, matrix_expression R>
+    struct Binary : expression
+    {
+        L left;
+        R right;
+
+        __m256d load(std::size_t i) const { return Op::apply(left.load(i), right.load(i)); }
+        double at(std::size_t i) const { return Op::apply(left.at(i), right.at(i)); }
+        auto row(std::size_t r) const
+        {
+            return Binary<Op, decltype(left.row(r)), decltype(right.row(r))>{{}, left.row(r), right.row(r)};
+        }
+        bool dense(std::size_t cols) const { return left.dense(cols) && right.dense(cols); }
+    };
+
+    // Узел a * b + c одной инструкцией FMA
+    template <matrix_expression A, matrix_expression B, matrix_expression C>
+    struct Fma : expression
+    {
+        A a;
+        B b;
+        C c;
+
+        __m256d load(std::size_t i) const
+        {
+#ifdef __FMA__
+            return _mm256_fmadd_pd(a.load(i), b.load(i), c.load(i));
+#else
+            return _mm256_add_pd(_mm256_mul_pd(a.load(i), b.load(i)), c.load(i));
+#endif
+        }
+
+        double at(std::size_t i) const { return a.at(i) * b.at(i) + c.at(i); }
+
+        auto row(std::size_t r) const
+        {
+            return Fma<decltype(a.row(r)), decltype(b.row(r)), decltype(c.row(r))>{{}, a.row(r), b.row(r), c.row(r)};
+        }
+        bool dense(std::size_t cols) const { return a.dense(cols) && b.dense(cols) && c.dense(cols); }
+    };
+
+    // Операнд-число превращается в Scalar, выражения передаются как есть
+    template <class T>
+    auto operand(const T& value)
+    {
+        if constexpr (matrix_expression<T>)
+            return value;
+        else
+            return Scalar{{}, static_cast<double>(value)};
+    }
+
+    template <class T>
+    concept operand_type = matrix_expression<T> || std::is_arithmetic_v<T>;
+
+    // Хотя бы один из операндов должен быть выражением, иначе это обычная арифметика
+    template <class L, class R>
+    concept expression_operands = operand_type<L> && operand_type<R> && (matrix_expression<L> || matrix_expression<R>);
+
+    template <class Op, class L, class R>
+    auto make(const L& left, const R& right)
+    {
+        using LE = decltype(operand(left));
+        using RE = decltype(operand(right));
+        return Binary<Op, LE, RE>{{}, operand(left), operand(right)};
+    }
+
+    template <class L, class R> requires expression_operands<L, R>
+    auto operator+(const L& left, const R& right) { return make<Add>(left, right); }
+
+    template <class L, class R> requires expression_operands<L, R>
+    auto operator-(const L& left, const R& right) { return make<Sub>(left, right); }
+
+    template <class L, class R> requires expression_operands<L, R>
+    auto operator*(const L& left, const R& right) { return make<Mul>(left, right); }
+
+    template <class L, class R> requires expression_operands<L, R>
+    auto min(const L& left, const R& right) { return make<Min>(left, right); }
+
+    template <class L, class R> requires expression_operands<L, R>
+    auto max(const L& left, const R& right) { return make<Max>(left, right); }
+
+    template <class A, class B, class C> requires operand_type<A> && operand_type<B> && operand_type<C>
+    auto fma(const A& a, const B& b, const C& c)
+    {
+        using AE = decltype(operand(a));
+        using BE = decltype(operand(b));
+        using CE = decltype(operand(c));
+        return Fma<AE, BE, CE>{{}, operand(a), operand(b), operand(c)};
+    }
+
+    // Матрица-приёмник: присваивание выражения вычисляет его за один проход
+    struct Matrix : Ref
+    {
+        std::size_t cols, rows;
+
+        Matrix(double* data, std::size_t colsc, std::size_t rowsc, std::size_t ld)
+            : Ref{{}, data, ld}, cols(colsc), rows(rowsc)
+        {
+        }
+        Matrix(const Matrix&) = default; // Копия - та же матрица (для узлов дерева)
+
+        template <matrix_expression E>
+        Matrix& operator=(const E& e)
+        {
+            double* out = const_cast<double*>(data);
+
+            if (Ref::dense(cols) && e.dense(cols)) // Все матрицы плотные - один проход по массиву
+            {
+                assignRange(out, e, cols * rows);
+                return *this;
+            }
+
+#pragma omp parallel for schedule(static)
+            for (std::size_t r = 0; r < rows; r++)
+            {
+                assignRange(out + r * ld, e.row(r), cols);
+            }
+            return *this;
+        }
+
+        // A = B копирует элементы, а не указатель
+        Matrix& operator=(const Matrix& other) { return *this = static_cast<const Ref&>(other); }
+
+    private:
+        // Элементы [0, n) от out: пакеты по 4 и скалярный хвост
+        template <matrix_expression E>
+        static void assignRange(double* out, const E& e, std::size_t n)
+        {
+            const std::size_t full = n / batch * batch;
+
+#pragma omp parallel for schedule(static) if (!omp_in_parallel())
+            for (std::size_t i = 0; i < full; i += batch)
+            {
+                _mm256_storeu_pd(out + i, e.load(i));
+            }
+
+            for (std::size_t i = full; i < n; i++) // Хвост
+            {
+                out[i] = e.at(i);
+            }
+        }
+    };
+
+    // Обёртка над готовым буфером для использования в выражениях
+    inline Matrix lazy(double* data, std::size_t colsc, std::size_t rowsc) { return Matrix(data, colsc, rowsc, colsc); }
+
+    // Обёртка над окном матрицы
+    inline Matrix lazy(MatrixView<double> view) { return Matrix(view.data, view.cols, view.rows, view.ld); }
+
+    // Окно только для чтения - лист выражения, присваивать в него нельзя
+    inline Ref lazy(MatrixView<const double> view) { return Ref{{}, view.data, view.ld}; }
+}
@@ -0,0 +1,58 @@
+/* Представление подматрицы без копирования - основные моменты:
+    MatrixView - указатель на первый элемент, количество столбцов и строк и ведущая размерность ld
+    (расстояние между началами соседних строк в элементах). Окно 4096 x 4096 в матрице 32768 x 32768 -
+    это тот же буфер с ld = 32768, данные никуда не копируются.
+
+    Ядра, принимающие MatrixView (simd_add.h, parallel_add.h, addMatrix256, шаблоны выражений):
+        * если все операнды непрерывны (ld == cols или одна строка), обрабатывают их одним проходом,
+          как обычный плотный массив;
+        * иначе идут по строкам, каждая строка - тем же SIMD-циклом с хвостом. */
+
+#pragma once
+#include <cstddef>
+#include <type_traits>
+#include "../common/aligned_matrix.h"
+
+template <class T>
+struct MatrixView
+{
+    T* data;         // Первый элемент
+    std::size_t cols; // Элементов в строке
+    std::size_t rows; // Количество строк
+    std::size_t ld;   // Ведущая размерность (шаг строк в элементах)
+
+    // Неизменяемое представление того же окна
+    operator MatrixView<const T>() const requires(!std::is_const_v<T>) { return {data, cols, rows, ld}; }
+
+    T* row(std::size_t r) const { return data + r * ld; }
+    T& operator()(std::size_t r, std::size_t c) const { return data[r * ld + c]; }
+
+    // Строки лежат подряд без промежутков
+    bool contiguous() const { return ld == cols || rows <= 1; }
+
+    // Окно colsc x rowsc, начинающееся в строке r и столбце c
+    MatrixView sub(std::size_t r, std::size_t c, std::size_t colsc, std::size_t rowsc) const
+    {
+        return MatrixView{data + r * ld + c, colsc, rowsc, ld};
+    }
+};
+
+// Плотная матрица colsc x rowsc
+template <class T>
+MatrixView<T> denseView(T* data, std::size_t colsc, std::size_t rowsc)
+{
+    return MatrixView<T>{data, colsc, rowsc, colsc};
+}
+
+// Вся выровненная матрица (ld - длина строки с дополнением)
+template <class T>
+MatrixView<T> viewOf(AlignedMatrix<T>& A)
+{
+    return MatrixView<T>{A.data(), A.cols(), A.rows(), A.stride()};
+}
+
+template <class T>
+MatrixView<const T> viewOf(const AlignedMatrix<T>& A)
+{
+    return MatrixView<const T>{A.data(), A.cols(), A.rows(), A.stride()};
+}
@@ -0,0 +1,119 @@
+/* Реализация параллельного сложения матриц (OpenMP + AVX).
+    * Полосы строк считаются одинаково в fillMatrixParallel и addMatrixParallel.
+    * Ядро сложения - шаблон по способу записи: обычная _mm256_store_pd или потоковая _mm256_stream_pd.
+    * Для окон (MatrixView) ядро вызывается отдельно для каждой строки окна. */
+
+#include "parallel_add.h"
+#include <immintrin.h>
+#include <omp.h>
+#include <cstdint>
+#include <unistd.h>
+
+std::size_t lastLevelCacheSize()
+{
+    long size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (size <= 0)
+        size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    return size > 0 ? static_cast<std::size_t>(size) : std::size_t(32) << 20;
+}
+
+std::unique_ptr<double[]> allocateMatrix(std::size_t colsc, std::size_t rowsc)
+{
+    return std::unique_ptr<double[]>(new double[colsc * rowsc]); // Без () - элементы не инициализируются
+}
+
+namespace
+{
+    // Элементы [b, e) полосы строк потока t из T (полоса - целое число строк длины colsc)
+    struct stripe
+    {
+        std::size_t b, e;
+    };
+
+    stripe rowStripe(std::size_t colsc, std::size_t rowsc, std::size_t T, std::size_t t)
+    {
+        return stripe{rowsc * t / T * colsc, rowsc * (t + 1) / T * colsc};
+    }
+
+    // Сложение элементов [b, e); Stream - писать результат мимо кэша
+    template <bool Stream>
+    void addRange(double* A, const double* B, const double* C, std::size_t b, std::size_t e)
+    {
+        const std::size_t batch = 4; // Размер пакета для AVX (4 double)
+        std::size_t i = b;
+
+        // Скалярная голова до выравнивания A на 32 байта (обязательно для _mm256_stream_pd)
+        for (; i < e && (reinterpret_cast<std::uintptr_t>(A + i) & 31); i++)
+        {
+            A[i] = B[i] + C[i];
+        }
+
+        for (; i + batch <= e; i += batch)
+        {
+            __m256d b = _mm256_loadu_pd(B + i);
+            __m256d c = _mm256_loadu_pd(C + i);
+            __m256d a = _mm256_add_pd(b, c);
+            if constexpr (Stream)
+                _mm256_stream_pd(A + i, a);
+            else
+                _mm256_store_pd(A + i, a);
+        }
+
+        for (; i < e; i++) // Хвост
+        {
+            A[i] = B[i] + C[i];
+        }
+
+        if constexpr (Stream)
+            _mm_sfence(); // Потоковые записи должны стать видимы до выхода из параллельной секции
+    }
+}
+
+void fillMatrixParallel(double* A, double value, std::size_t colsc, std::size_t rowsc)
+{
+#pragma omp parallel proc_bind(spread)
+    {
+        auto [b, e] = rowStripe(colsc, rowsc, omp_get_num_threads(), omp_get_thread_num());
+        for (std::size_t i = b; i < e; i++)
+        {
+            A[i] = value; // Первое обращение - страница выделяется на узле этого потока
+        }
+    }
+}
+
+void addMatrixParallel(double* A, const double* B, const double* C, std::size_t colsc, std::size_t rowsc)
+{
+    const bool stream = colsc * rowsc * sizeof(double) > lastLevelCacheSize();
+
+#pragma omp parallel proc_bind(spread)
+    {
+        auto [b, e] = rowStripe(colsc, rowsc, omp_get_num_threads(), omp_get_thread_num());
+        if (stream)
+            addRange<true>(A, B, C, b, e);
+        else
+            addRange<false>(A, B, C, b, e);
+    }
+}
+
+void addMatrixParallel(MatrixView<double> A, MatrixView<const double> B, MatrixView<const double> C)
+{
+    if (A.contiguous() && B.contiguous() && C.contiguous())
+    {
+        addMatrixParallel(A.data, B.data, C.data, A.cols, A.rows);
+        return;
+    }
+
+    const bool stream = A.cols * A.rows * sizeof(double) > lastLevelCacheSize();
+
+#pragma omp parallel proc_bind(spread)
+    {
+        const std::size_t T = omp_get_num_threads(), t = omp_get_thread_num();
+        for (std::size_t r = A.rows * t / T; r < A.rows * (t + 1) / T; r++)
+        {
+            if (stream)
+                addRange<true>(A.row(r), B.row(r), C.row(r), 0, A.cols);
+            else
+                addRange<false>(A.row(r), B.row(r), C.row(r), 0, A.cols);
+        }
+    }
+}
@@ -0,0 +1,40 @@
+/* Параллельное сложение матриц - основные моменты:
+    Сложение упирается в пропускную способность памяти, поэтому важно, где лежат страницы и как
+    пишется результат.
+
+    Разбиение:
+        Строки матрицы делятся на T непрерывных полос, поток t обрабатывает полосу t.
+
+    Размещение страниц (first touch):
+        Linux выделяет физическую страницу на NUMA-узле потока, который первым к ней обратился.
+        Матрицы выделяются без инициализации (allocateMatrix) и заполняются fillMatrixParallel с тем же
+        разбиением на полосы, поэтому каждый поток потом складывает строки, лежащие на его узле.
+        Потоки закрепляются за ядрами через proc_bind(spread) в обеих функциях.
+
+    Потоковая запись:
+        Если результат больше кэша последнего уровня, он пишется _mm256_stream_pd мимо кэша:
+        строки результата не вытесняют входные данные и не читаются перед записью.
+
+    Окна матриц (MatrixView):
+        Перегрузка addMatrixParallel для окон делит на полосы строки окна; каждая строка окна
+        складывается тем же ядром, что и плотная матрица. */
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include "matrix_view.h"
+
+// Размер кэша последнего уровня в байтах (32 МБ, если система его не сообщает)
+std::size_t lastLevelCacheSize();
+
+// Матрица colsc x rowsc без инициализации: страницы ещё не выделены физически
+std::unique_ptr<double[]> allocateMatrix(std::size_t colsc, std::size_t rowsc);
+
+// Параллельное заполнение значением value с тем же разбиением по потокам, что и addMatrixParallel
+void fillMatrixParallel(double* A, double value, std::size_t colsc, std::size_t rowsc);
+
+// Параллельное сложение A = B + C: полосы строк по потокам OpenMP, AVX, потоковая запись для больших A
+void addMatrixParallel(double* A, const double* B, const double* C, std::size_t colsc, std::size_t rowsc);
+
+// Параллельное сложение окон A = B + C (ld у окон может быть любым)
+void addMatrixParallel(MatrixView<double> A, MatrixView<const double> B, MatrixView<const double> C);
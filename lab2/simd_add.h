@@ -0,0 +1,327 @@
+/* Сложение матриц произвольного типа элементов - основные моменты:
+    Типы элементов: double, float, int32_t, int64_t и bfloat16 (16-битный формат хранения).
+
+    Ширина пакета:
+        Регистр и инструкции для каждого типа выбираются на этапе компиляции через simd_element<T>:
+        при -mavx512f регистр 512 бит (8 double, 16 float/int32, 8 int64, 16 bfloat16),
+        при -mavx2 - 256 бит (вдвое меньше элементов), без них - скалярный вариант.
+
+    bfloat16:
+        Старшие 16 бит float. Значения хранятся в 2 байтах, а складываются как float: при загрузке
+        расширяются сдвигом влево на 16 бит, при записи округляются к ближайшему чётному.
+        Объём памяти и трафик вдвое меньше, чем у float. NaN отдельно не обрабатываются.
+
+    Ядра:
+        * addMatrix      - скалярное сложение (для сравнения);
+        * addMatrixSimd  - сложение пакетами, невыровненные загрузки;
+        * перегрузки для AlignedMatrix используют выровненные загрузки (строки выровнены на 64 байта);
+        * перегрузки для MatrixView складывают окна матриц без копирования. */
+
+#pragma once
+#include <immintrin.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "../common/aligned_matrix.h"
+#include "matrix_view.h"
+
+// 16-битное число bfloat16: старшая половина float
+struct bfloat16
+{
+    std::uint16_t bits;
+
+    bfloat16() = default;
+
+    // Округление к ближайшему, при равенстве - к чётному
+    bfloat16(float value)
+    {
+        std::uint32_t x;
+        std::memcpy(&x, &value, sizeof(x));
+        bits = static_cast<std::uint16_t>((x + 0x7FFF + ((x >> 16) & 1)) >> 16);
+    }
+
+    operator float() const
+    {
+        const std::uint32_t x = static_cast<std::uint32_t>(bits) << 16;
+        float value;
+        std::memcpy(&value, &x, sizeof(value));
+        return value;
+    }
+};
+
+// Пакет элементов типа T: регистр, загрузка, запись и сложение.
+// Общий вариант - скалярный (один элемент)
+template <class T>
+struct simd_element
+{
+    using type = T;
+    static constexpr std::size_t lanes = 1;
+    static type load(const T* p) { return *p; }
+    static type loada(const T* p) { return *p; }
+    static void store(T* p, type v) { *p = v; }
+    static void storea(T* p, type v) { *p = v; }
+    static type add(type x, type y) { return x + y; }
+};
+
+#if defined(__AVX512F__)
+
+template <>
+struct simd_element<double>
+{
+    using type = __m512d;
+    static constexpr std::size_t lanes = 8;
+    static __m512d load(const double* p) { return _mm512_loadu_pd(p); }
+    static __m512d loada(const double* p) { return _mm512_load_pd(p); }
+    static void store(double* p, __m512d v) { _mm512_storeu_pd(p, v); }
+    static void storea(double* p, __m512d v) { _mm512_store_pd(p, v); }
+    static __m512d add(__m512d x, __m512d y) { return _mm512_add_pd(x, y); }
+};
+
+template <>
+struct simd_element<float>
+{
+    using type = __m512;
+    static constexpr std::size_t lanes = 16;
+    static __m512 load(const float* p) { return _mm512_loadu_ps(p); }
+    static __m512 loada(const float* p) { return _mm512_load_ps(p); }
+    static void store(float* p, __m512 v) { _mm512_storeu_ps(p, v); }
+    static void storea(float* p, __m512 v) { _mm512_store_ps(p, v); }
+    static __m512 add(__m512 x, __m512 y) { return _mm512_add_ps(x, y); }
+};
+
+template <>
+struct simd_element<std::int32_t>
+{
+    using type = __m512i;
+    static constexpr std::size_t lanes = 16;
+    static __m512i load(const std::int32_t* p) { return _mm512_loadu_si512(p); }
+    static __m512i loada(const std::int32_t* p) { return _mm512_load_si512(p); }
+    static void store(std::int32_t* p, __m512i v) { _mm512_storeu_si512(p, v); }
+    static void storea(std::int32_t* p, __m512i v) { _mm512_store_si512(p, v); }
+    static __m512i add(__m512i x, __m512i y) { return _mm512_add_epi32(x, y); }
+};
+
+template <>
+struct simd_element<std::int64_t>
+{
+    using type = __m512i;
+    static constexpr std::size_t lanes = 8;
+    static __m512i load(const std::int64_t* p) { return _mm512_loadu_si512(p); }
+    static __m512i loada(const std::int64_t* p) { return _mm512_load_si512(p); }
+    static void store(std::int64_t* p, __m512i v) { _mm512_storeu_si512(p, v); }
+    static void storea(std::int64_t* p, __m512i v) { _mm512_store_si512(p, v); }
+    static __m512i add(__m512i x, __m512i y) { return _mm512_add_epi64(x, y); }
+};
+
+// 16 bfloat16 (32 байта) расширяются до 16 float
+template <>
+struct simd_element<bfloat16>
+{
+    using type = __m512;
+    static constexpr std::size_t lanes = 16;
+
+    static __m512 load(const bfloat16* p)
+    {
+        const __m512i wide = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+        return _mm512_castsi512_ps(_mm512_slli_epi32(wide, 16));
+    }
+    static __m512 loada(const bfloat16* p) { return load(p); }
+
+    static void store(bfloat16* p, __m512 v)
+    {
+        const __m512i x = _mm512_castps_si512(v);
+        const __m512i odd = _mm512_and_si512(_mm512_srli_epi32(x, 16), _mm512_set1_epi32(1));
+        const __m512i rounded = _mm512_add_epi32(x, _mm512_add_epi32(odd, _mm512_set1_epi32(0x7FFF)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm512_cvtepi32_epi16(_mm512_srli_epi32(rounded, 16)));
+    }
+    static void storea(bfloat16* p, __m512 v) { store(p, v); }
+
+    static __m512 add(__m512 x, __m512 y) { return _mm512_add_ps(x, y); }
+};
+
+#elif defined(__AVX2__)
+
+template <>
+struct simd_element<double>
+{
+    using type = __m256d;
+    static constexpr std::size_t lanes = 4;
+    static __m256d load(const double* p) { return _mm256_loadu_pd(p); }
+    static __m256d loada(const double* p) { return _mm256_load_pd(p); }
+    static void store(double* p, __m256d v) { _mm256_storeu_pd(p, v); }
+    static void storea(double* p, __m256d v) { _mm256_store_pd(p, v); }
+    static __m256d add(__m256d x, __m256d y) { return _mm256_add_pd(x, y); }
+};
+
+template <>
+struct simd_element<float>
+{
+    using type = __m256;
+    static constexpr std::size_t lanes = 8;
+    static __m256 load(const float* p) { return _mm256_loadu_ps(p); }
+    static __m256 loada(const float* p) { return _mm256_load_ps(p); }
+    static void store(float* p, __m256 v) { _mm256_storeu_ps(p, v); }
+    static void storea(float* p, __m256 v) { _mm256_store_ps(p, v); }
+    static __m256 add(__m256 x, __m256 y) { return _mm256_add_ps(x, y); }
+};
+
+template <>
+struct simd_element<std::int32_t>
+{
+    using type = __m256i;
+    static constexpr std::size_t lanes = 8;
+    static __m256i load(const std::int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static __m256i loada(const std::int32_t* p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(std::int32_t* p, __m256i v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static void storea(std::int32_t* p, __m256i v) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), v); }
+    static __m256i add(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+};
+
+template <>
+struct simd_element<std::int64_t>
+{
+    using type = __m256i;
+    static constexpr std::size_t lanes = 4;
+    static __m256i load(const std::int64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static __m256i loada(const std::int64_t* p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(std::int64_t* p, __m256i v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static void storea(std::int64_t* p, __m256i v) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), v); }
+    static __m256i add(__m256i x, __m256i y) { return _mm256_add_epi64(x, y); }
+};
+
+// 8 bfloat16 (16 байт) расширяются до 8 float
+template <>
+struct simd_element<bfloat16>
+{
+    using type = __m256;
+    static constexpr std::size_t lanes = 8;
+
+    static __m256 load(const bfloat16* p)
+    {
+        const __m256i wide = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(wide, 16));
+    }
+    static __m256 loada(const bfloat16* p) { return load(p); }
+
+    static void store(bfloat16* p, __m256 v)
+    {
+        const __m256i x = _mm256_castps_si256(v);
+        const __m256i odd = _mm256_and_si256(_mm256_srli_epi32(x, 16), _mm256_set1_epi32(1));
+        const __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(x, _mm256_add_epi32(odd, _mm256_set1_epi32(0x7FFF))), 16);
+        // packus работает внутри 128-битных половин: собираем нижние 64 бита каждой половины
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(rounded, rounded), 0b1000);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_castsi256_si128(packed));
+    }
+    static void storea(bfloat16* p, __m256 v) { store(p, v); }
+
+    static __m256 add(__m256 x, __m256 y) { return _mm256_add_ps(x, y); }
+};
+
+#else
+
+// Без AVX2 bfloat16 складывается поэлементно во float
+template <>
+struct simd_element<bfloat16>
+{
+    using type = float;
+    static constexpr std::size_t lanes = 1;
+    static float load(const bfloat16* p) { return *p; }
+    static float loada(const bfloat16* p) { return *p; }
+    static void store(bfloat16* p, float v) { *p = v; }
+    static void storea(bfloat16* p, float v) { *p = v; }
+    static float add(float x, float y) { return x + y; }
+};
+
+#endif
+
+// Скалярное сложение A = B + C
+template <class T>
+void addMatrix(T* A, const T* B, const T* C, std::size_t colsc, std::size_t rowsc)
+{
+    for (std::size_t i = 0; i < colsc * rowsc; i++)
+    {
+        A[i] = B[i] + C[i];
+    }
+}
+
+// Сложение элементов [0, n) пакетами по simd_element<T>::lanes; Aligned - указатели выровнены на регистр
+template <class T, bool Aligned = false>
+void addRangeSimd(T* A, const T* B, const T* C, std::size_t n)
+{
+    using simd = simd_element<T>;
+    const std::size_t full = n / simd::lanes * simd::lanes; // Граница целых пакетов
+
+    for (std::size_t i = 0; i < full; i += simd::lanes)
+    {
+        if constexpr (Aligned)
+            simd::storea(A + i, simd::add(simd::loada(B + i), simd::loada(C + i)));
+        else
+            simd::store(A + i, simd::add(simd::load(B + i), simd::load(C + i)));
+    }
+
+    for (std::size_t j = full; j < n; j++) // Хвост
+    {
+        A[j] = B[j] + C[j];
+    }
+}
+
+// Векторное сложение A = B + C
+template <class T>
+void addMatrixSimd(T* A, const T* B, const T* C, std::size_t colsc, std::size_t rowsc)
+{
+    addRangeSimd(A, B, C, colsc * rowsc);
+}
+
+// Скалярное сложение выровненных матриц (по строкам, дополнение строк не трогается)
+template <class T>
+void addMatrix(AlignedMatrix<T>& A, const AlignedMatrix<T>& B, const AlignedMatrix<T>& C)
+{
+    for (std::size_t r = 0; r < A.rows(); r++)
+    {
+        addMatrix(A.row(r), B.row(r), C.row(r), A.cols(), 1);
+    }
+}
+
+// Векторное сложение выровненных матриц: строки начинаются на границе 64 байт, загрузки выровненные
+template <class T>
+void addMatrixSimd(AlignedMatrix<T>& A, const AlignedMatrix<T>& B, const AlignedMatrix<T>& C)
+{
+    for (std::size_t r = 0; r < A.rows(); r++)
+    {
+        addRangeSimd<T, true>(A.row(r), B.row(r), C.row(r), A.cols());
+    }
+}
+
+// Скалярное сложение окон A = B + C: непрерывные - одним проходом, иначе по строкам
+template <class T>
+void addMatrix(MatrixView<T> A, std::type_identity_t<MatrixView<const T>> B, std::type_identity_t<MatrixView<const T>> C)
+{
+    if (A.contiguous() && B.contiguous() && C.contiguous())
+    {
+        addMatrix(A.data, B.data, C.data, A.cols, A.rows);
+        return;
+    }
+
+    for (std::size_t r = 0; r < A.rows; r++)
+    {
+        addMatrix(A.row(r), B.row(r), C.row(r), A.cols, 1);
+    }
+}
+
+// Векторное сложение окон A = B + C: непрерывные - одним проходом, иначе по строкам
+template <class T>
+void addMatrixSimd(MatrixView<T> A, std::type_identity_t<MatrixView<const T>> B,
+                   std::type_identity_t<MatrixView<const T>> C)
+{
+    if (A.contiguous() && B.contiguous() && C.contiguous())
+    {
+        addRangeSimd(A.data, B.data, C.data, A.cols * A.rows);
+        return;
+    }
+
+    for (std::size_t r = 0; r < A.rows; r++)
+    {
+        addRangeSimd(A.row(r), B.row(r), C.row(r), A.cols);
+    }
+}
@@ -0,0 +1,192 @@
+/* Реализация сложения матриц из отображённых файлов.
+    * MappedMatrix - mmap файла матрицы, подкачка, запуск записи и освобождение диапазонов страниц.
+    * streamAddMatrix - цикл по тайлам: подкачка тайла k + 1 в отдельном потоке (std::async),
+      сложение тайла k через addMatrixParallel, освобождение обработанных тайлов. */
+
+#include "stream_add.h"
+#include "parallel_add.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedMatrix::MappedMatrix(const std::string& path, std::size_t colsc, std::size_t rowsc, map_mode mode)
+    : cols_(colsc), rows_(rowsc), mode_(mode)
+{
+    const std::size_t bytes = size() * sizeof(double);
+
+    fd_ = mode == map_mode::read ? open(path.c_str(), O_RDONLY) : open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0)
+        throw std::runtime_error("Couldn't open file " + path + ": " + std::strerror(errno));
+
+    struct stat info;
+    if (mode == map_mode::read && (fstat(fd_, &info) != 0 || static_cast<std::size_t>(info.st_size) < bytes))
+    {
+        close(fd_);
+        throw std::runtime_error("File " + path + " is smaller than the matrix");
+    }
+    if (mode == map_mode::write && ftruncate(fd_, bytes) != 0)
+    {
+        close(fd_);
+        throw std::runtime_error("Couldn't resize file " + path + ": " + std::strerror(errno));
+    }
+
+    const int protection = mode == map_mode::read ? PROT_READ : PROT_READ | PROT_WRITE;
+    const int flags = mode == map_mode::read ? MAP_PRIVATE : MAP_SHARED; // Запись результата должна попасть в файл
+    data_ = mmap(nullptr, bytes, protection, flags, fd_, 0);
+    if (data_ == MAP_FAILED)
+    {
+        close(fd_);
+        throw std::runtime_error("Couldn't map file " + path + ": " + std::strerror(errno));
+    }
+
+    madvise(data_, bytes, MADV_SEQUENTIAL); // Файл читается подряд - включаем упреждающее чтение
+}
+
+MappedMatrix::~MappedMatrix()
+{
+    munmap(data_, size() * sizeof(double));
+    close(fd_);
+}
+
+namespace
+{
+    // Байты [first, last) файла
+    struct byte_range
+    {
+        std::size_t first, last;
+    };
+
+    // Страницы, задевающие элементы [begin, end)
+    byte_range outerPages(std::size_t begin, std::size_t end)
+    {
+        const std::size_t page = sysconf(_SC_PAGESIZE);
+        return byte_range{begin * sizeof(double) / page * page, (end * sizeof(double) + page - 1) / page * page};
+    }
+
+    // Страницы, целиком лежащие в элементах [begin, end)
+    byte_range innerPages(std::size_t begin, std::size_t end)
+    {
+        const std::size_t page = sysconf(_SC_PAGESIZE);
+        return byte_range{(begin * sizeof(double) + page - 1) / page * page, end * sizeof(double) / page * page};
+    }
+}
+
+void MappedMatrix::prefetch(std::size_t begin, std::size_t end) const
+{
+    const auto [first, last] = outerPages(begin, end);
+    if (first >= last)
+        return;
+
+    const char* bytes = static_cast<const char*>(data_);
+    madvise(const_cast<char*>(bytes) + first, last - first, MADV_WILLNEED);
+
+    // Касание страниц: ожидание чтения с диска происходит здесь, а не в потоках сложения
+    const std::size_t page = sysconf(_SC_PAGESIZE);
+    volatile char sink = 0;
+    for (std::size_t i = first; i < last; i += page)
+    {
+        sink = sink + bytes[i];
+    }
+}
+
+void MappedMatrix::flush(std::size_t begin, std::size_t end) const
+{
+    const auto [first, last] = outerPages(begin, end);
+    if (mode_ == map_mode::write && first < last)
+        sync_file_range(fd_, first, last - first, SYNC_FILE_RANGE_WRITE);
+}
+
+void MappedMatrix::release(std::size_t begin, std::size_t end) const
+{
+    const auto [first, last] = innerPages(begin, end);
+    if (first >= last)
+        return;
+
+    if (mode_ == map_mode::write) // Грязные страницы можно выбросить только после записи на диск
+        sync_file_range(fd_, first, last - first,
+                        SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+
+    madvise(static_cast<char*>(data_) + first, last - first, MADV_DONTNEED); // Из отображения процесса
+    posix_fadvise(fd_, first, last - first, POSIX_FADV_DONTNEED);            // Из страничного кэша
+}
+
+void writeMatrixFile(const std::string& path, double value, std::size_t colsc, std::size_t rowsc)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Couldn't open file " + path);
+
+    const std::size_t portion = 1 << 20;
+    const std::vector<double> values(portion, value);
+    const std::size_t n = colsc * rowsc;
+
+    for (std::size_t i = 0; i < n; i += portion)
+    {
+        const std::size_t count = std::min(portion, n - i);
+        file.write(reinterpret_cast<const char*>(values.data()), count * sizeof(double));
+    }
+
+    if (!file)
+        throw std::runtime_error("Couldn't write file " + path);
+}
+
+void streamAddMatrix(MappedMatrix& A, const MappedMatrix& B, const MappedMatrix& C, std::size_t tileRows)
+{
+    const std::size_t colsc = A.cols(), rowsc = A.rows();
+    const std::size_t tiles = (rowsc + tileRows - 1) / tileRows;
+
+    // Первый элемент тайла k (для k == tiles - конец матрицы)
+    auto tileBegin = [&](std::size_t k) { return std::min(k * tileRows, rowsc) * colsc; };
+
+    auto load = [&](std::size_t k)
+    {
+        B.prefetch(tileBegin(k), tileBegin(k + 1));
+        C.prefetch(tileBegin(k), tileBegin(k + 1));
+    };
+
+    std::future<void> next = std::async(std::launch::async, load, 0);
+    for (std::size_t k = 0; k < tiles; k++)
+    {
+        next.get(); // Тайл k подкачан
+        if (k + 1 < tiles)
+            next = std::async(std::launch::async, load, k + 1);
+
+        const std::size_t b = tileBegin(k), e = tileBegin(k + 1);
+        addMatrixParallel(A.data() + b, B.data() + b, C.data() + b, colsc, e / colsc - b / colsc);
+        A.flush(b, e);
+
+        B.release(b, e);
+        C.release(b, e);
+        if (k > 0) // Запись предыдущего тайла результата к этому моменту обычно уже закончена
+            A.release(tileBegin(k - 1), b);
+    }
+
+    if (tiles > 0)
+        A.release(tileBegin(tiles - 1), tileBegin(tiles));
+}
+
+std::size_t peakResidentBytes()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.rfind("VmHWM:", 0) == 0)
+            return std::stoull(line.substr(6)) * 1024; // Значение в кБ
+    }
+    return 0;
+}
+
+void resetPeakResident()
+{
+    std::ofstream clear("/proc/self/clear_refs");
+    clear << "5"; // Сбрасывает VmHWM до текущего объёма резидентной памяти
+}
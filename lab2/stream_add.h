@@ -0,0 +1,73 @@
+/* Сложение матриц, не помещающихся в память - основные моменты:
+    Матрицы лежат в двоичных файлах (double подряд, по строкам) и отображаются в память (mmap):
+    входные - только для чтения, результат - общим отображением на запись (MAP_SHARED).
+
+    Тайлы:
+        Сложение идёт по тайлам из целого числа строк. Тайл складывается addMatrixParallel,
+        как обычная матрица в памяти.
+
+    Двойная буферизация:
+        Пока потоки OpenMP складывают тайл k, отдельный поток подкачивает тайл k + 1 входных файлов
+        (madvise(MADV_WILLNEED) запускает упреждающее чтение, затем касание каждой страницы), так что
+        чтение с диска перекрывается с вычислениями.
+
+    Ограничение памяти:
+        Обработанные тайлы входных файлов сразу освобождаются (MADV_DONTNEED + POSIX_FADV_DONTNEED).
+        Запись тайла результата на диск запускается сразу после сложения (sync_file_range), а освобождается
+        он на следующем шаге, когда запись уже завершена. Резидентными остаются не больше двух тайлов
+        каждого файла, независимо от размера матриц. */
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Режим отображения файла матрицы
+enum class map_mode
+{
+    read, // Существующий файл, только чтение
+    write // Файл создаётся (или обрезается) под размер матрицы
+};
+
+// Матрица colsc x rowsc, отображённая из файла
+class MappedMatrix
+{
+public:
+    // При ошибке открытия, нехватке данных в файле или ошибке отображения бросает std::runtime_error
+    MappedMatrix(const std::string& path, std::size_t colsc, std::size_t rowsc, map_mode mode);
+    ~MappedMatrix();
+
+    MappedMatrix(const MappedMatrix&) = delete;
+    MappedMatrix& operator=(const MappedMatrix&) = delete;
+
+    std::size_t cols() const { return cols_; }
+    std::size_t rows() const { return rows_; }
+    std::size_t size() const { return cols_ * rows_; } // Количество элементов
+
+    double* data() { return static_cast<double*>(data_); }
+    const double* data() const { return static_cast<const double*>(data_); }
+
+    // Подкачивает в память элементы [begin, end): упреждающее чтение и касание каждой страницы
+    void prefetch(std::size_t begin, std::size_t end) const;
+
+    // Запускает асинхронную запись на диск изменённых элементов [begin, end)
+    void flush(std::size_t begin, std::size_t end) const;
+
+    // Дожидается записи (для режима write) и освобождает страницы, целиком лежащие в [begin, end)
+    void release(std::size_t begin, std::size_t end) const;
+
+private:
+    int fd_ = -1;
+    void* data_ = nullptr;
+    std::size_t cols_, rows_;
+    map_mode mode_;
+};
+
+// Запись файла матрицы colsc x rowsc, заполненной значением value (порциями, без буфера на всю матрицу)
+void writeMatrixFile(const std::string& path, double value, std::size_t colsc, std::size_t rowsc);
+
+// Сложение A = B + C по тайлам из tileRows строк с подкачкой следующего тайла во время вычислений
+void streamAddMatrix(MappedMatrix& A, const MappedMatrix& B, const MappedMatrix& C, std::size_t tileRows);
+
+// Пиковый объём резидентной памяти процесса в байтах (VmHWM) и его сброс до текущего значения
+std::size_t peakResidentBytes();
+void resetPeakResident();
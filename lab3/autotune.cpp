@@ -0,0 +1,241 @@
+/* Реализация подбора настройки gemm и профиля.
+    * measure - GFLOPS gemmParallel для одной конфигурации, лучший из нескольких запусков.
+    * searchBlock - перебор одного размера блока при остальных фиксированных.
+    * cpuModel - "model name" из /proc/cpuinfo, по нему профиль привязан к процессору. */
+
+#include "autotune.h"
+#include <unistd.h>
+#include <omp.h>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <random>
+
+namespace
+{
+    // Кандидаты размеров блоков в элементах, округляются вверх до кратного mr или nr
+    constexpr std::size_t kc_candidates[] = {64, 128, 192, 256, 320, 384, 512};
+    constexpr std::size_t mc_candidates[] = {64, 128, 192, 256, 384, 512, 768, 1024};
+    constexpr std::size_t nc_candidates[] = {256, 512, 1024, 2048, 4096};
+
+    // Прогрев перед поиском и наименьшее время замеров одной конфигурации (для малых n - больше запусков)
+    constexpr std::chrono::milliseconds warmup(500), min_time(100);
+
+    std::size_t roundUp(std::size_t value, std::size_t step)
+    {
+        return (value + step - 1) / step * step;
+    }
+
+    bool sameConfig(const gemm_config& a, const gemm_config& b)
+    {
+        return a.kernel.mr == b.kernel.mr && a.kernel.nr == b.kernel.nr && a.blocking.mc == b.blocking.mc &&
+               a.blocking.kc == b.blocking.kc && a.blocking.nc == b.blocking.nc && a.grid == b.grid;
+    }
+
+    // Матрицы для замеров и сохранённые результаты
+    struct tuner
+    {
+        std::size_t n, repeats;
+        std::vector<double> A, B, C;
+        autotune_result result;
+
+        tuner(std::size_t n, std::size_t repeats)
+            : n(n), repeats(std::max<std::size_t>(repeats, 1)), A(n * n), B(n * n), C(n * n)
+        {
+            std::mt19937 generator(12345);
+            std::uniform_real_distribution<double> value(-1, 1);
+            for (std::size_t i = 0; i < n * n; i++)
+            {
+                B[i] = value(generator);
+                C[i] = value(generator);
+            }
+
+            // Разгон частоты процессора и создание потоков до первых замеров
+            const auto start = std::chrono::steady_clock::now();
+            while (std::chrono::steady_clock::now() - start < warmup)
+            {
+                gemmParallel(n, n, n, 1.0, B.data(), n, C.data(), n, 0.0, A.data(), n);
+            }
+        }
+
+        // GFLOPS конфигурации; повторные замеры той же конфигурации не делаются
+        double measure(const gemm_config& config)
+        {
+            for (const autotune_trial& trial : result.trials)
+            {
+                if (sameConfig(trial.config, config))
+                    return trial.gflops;
+            }
+            if (!setGemmConfig(config))
+                return 0;
+
+            gemmParallel(n, n, n, 1.0, B.data(), n, C.data(), n, 0.0, A.data(), n); // Прогрев: буферы, потоки
+            double best = 0;
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t r = 0; r < repeats || std::chrono::steady_clock::now() - start < min_time; r++)
+            {
+                auto t1 = std::chrono::steady_clock::now();
+                gemmParallel(n, n, n, 1.0, B.data(), n, C.data(), n, 0.0, A.data(), n);
+                auto t2 = std::chrono::steady_clock::now();
+                const double seconds = std::chrono::duration<double>(t2 - t1).count();
+                best = std::max(best, 2.0 * n * n * n / seconds / 1e9);
+            }
+
+            result.trials.push_back(autotune_trial{config, best});
+            if (best > result.gflops)
+            {
+                result.best = config;
+                result.gflops = best;
+            }
+            return best;
+        }
+
+        // Перебор одного размера блока (field) при остальных - из лучшей конфигурации
+        template <std::size_t N>
+        void searchBlock(std::size_t gemm_blocking::*field, const std::size_t (&candidates)[N], std::size_t step)
+        {
+            const gemm_config base = result.best;
+            for (std::size_t value : candidates)
+            {
+                gemm_config config = base;
+                config.blocking.*field = roundUp(value, step);
+                measure(config);
+            }
+        }
+    };
+
+    std::string cpuModel()
+    {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line))
+        {
+            if (line.rfind("model name", 0) == 0)
+            {
+                const std::size_t value = line.find_first_not_of(" \t", line.find(':') + 1);
+                if (line.find(':') != std::string::npos && value != std::string::npos)
+                    return line.substr(value);
+            }
+        }
+        return "unknown";
+    }
+
+    bool parseSize(const std::string& text, std::size_t& value)
+    {
+        const char* end = text.data() + text.size();
+        auto [ptr, error] = std::from_chars(text.data(), end, value);
+        return error == std::errc() && ptr == end;
+    }
+}
+
+autotune_result autotuneGemm(std::size_t n, std::size_t repeats)
+{
+    tuner t(n, repeats);
+
+    // Форма микроядра с блоками по размерам кэшей
+    for (const gemm_kernel& kernel : gemmKernels())
+    {
+        t.measure(gemm_config{gemmBlocking(kernel), kernel, gemm_grid::automatic});
+    }
+
+    // Блоки по одному, начиная с kc: от него зависят допустимые mc (L2) и nc (L3)
+    const gemm_kernel kernel = t.result.best.kernel;
+    t.searchBlock(&gemm_blocking::kc, kc_candidates, 8);
+    t.searchBlock(&gemm_blocking::mc, mc_candidates, kernel.mr);
+    t.searchBlock(&gemm_blocking::nc, nc_candidates, kernel.nr);
+
+    for (gemm_grid grid : {gemm_grid::automatic, gemm_grid::rows, gemm_grid::cols})
+    {
+        gemm_config config = t.result.best;
+        config.grid = grid;
+        t.measure(config);
+    }
+
+    setGemmConfig(t.result.best);
+    return std::move(t.result);
+}
+
+const char* gridName(gemm_grid grid)
+{
+    switch (grid)
+    {
+    case gemm_grid::rows:
+        return "rows";
+    case gemm_grid::cols:
+        return "cols";
+    default:
+        return "auto";
+    }
+}
+
+std::string gemmProfilePath()
+{
+    if (const char* path = std::getenv("GEMM_PROFILE"))
+        return path;
+
+    char host[256] = "local";
+    gethostname(host, sizeof(host) - 1);
+    return std::string("../gemm_profile_") + host + ".txt";
+}
+
+bool saveGemmProfile(const std::string& path, const gemm_config& config)
+{
+    std::ofstream profile(path);
+    if (!profile.is_open())
+        return false;
+
+    profile << "# Настройка gemm, подобранная autotuneGemm\n"
+            << "cpu=" << cpuModel() << "\n"
+            << "threads=" << omp_get_max_threads() << "\n"
+            << "mr=" << config.kernel.mr << "\n"
+            << "nr=" << config.kernel.nr << "\n"
+            << "mc=" << config.blocking.mc << "\n"
+            << "kc=" << config.blocking.kc << "\n"
+            << "nc=" << config.blocking.nc << "\n"
+            << "grid=" << gridName(config.grid) << "\n";
+    return profile.good();
+}
+
+bool loadGemmProfile(const std::string& path)
+{
+    std::ifstream profile(path);
+    if (!profile.is_open())
+        return false;
+
+    std::map<std::string, std::string> values;
+    std::string line;
+    while (std::getline(profile, line))
+    {
+        const std::size_t eq = line.find('=');
+        if (line.empty() || line[0] == '#' || eq == std::string::npos)
+            continue;
+        values[line.substr(0, eq)] = line.substr(eq + 1);
+    }
+
+    // Профиль другого процессора или другого числа потоков не подходит
+    std::size_t threads = 0;
+    if (values["cpu"] != cpuModel() || !parseSize(values["threads"], threads) ||
+        threads != static_cast<std::size_t>(omp_get_max_threads()))
+        return false;
+
+    gemm_config config;
+    if (!parseSize(values["mr"], config.kernel.mr) || !parseSize(values["nr"], config.kernel.nr) ||
+        !parseSize(values["mc"], config.blocking.mc) || !parseSize(values["kc"], config.blocking.kc) ||
+        !parseSize(values["nc"], config.blocking.nc))
+        return false;
+
+    const std::string& grid = values["grid"];
+    if (grid == "rows")
+        config.grid = gemm_grid::rows;
+    else if (grid == "cols")
+        config.grid = gemm_grid::cols;
+    else if (grid == "auto")
+        config.grid = gemm_grid::automatic;
+    else
+        return false;
+
+    return setGemmConfig(config);
+}
@@ -0,0 +1,51 @@
+/* Подбор настройки gemm под процессор - основные моменты:
+    Размеры блоков по кэшам (gemmBlocking) - только оценка: ассоциативность, предвыборка,
+    общий L3 и число потоков сдвигают оптимум. autotuneGemm измеряет gemmParallel на матрицах
+    n x n и ищет лучшую gemm_config покоординатно:
+        * форма микроядра - каждая из gemmKernels() с блоками по кэшам;
+        * kc, затем mc (кратно mr), затем nc (кратно nr) - при лучших найденных остальных;
+        * раскладка потоков - automatic, rows, cols.
+    Перед поиском gemm прогревается 0.5 с (частота процессора, потоки); время конфигурации - лучшее
+    из запусков после прогревочного: не меньше repeats и не меньше 0.1 с в сумме.
+
+    Профиль - текстовый файл "ключ=значение" (saveGemmProfile / loadGemmProfile):
+        * cpu и threads - модель процессора и число потоков OpenMP, для которых он подобран:
+          профиль с другой машины или с другим числом потоков не загружается;
+        * mr, nr, mc, kc, nc, grid - сама настройка, проверяется setGemmConfig.
+    Путь по умолчанию - ../gemm_profile_<имя хоста>.txt, переменная окружения GEMM_PROFILE его заменяет. */
+
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "gemm.h"
+
+// Одна измеренная конфигурация
+struct autotune_trial
+{
+    gemm_config config;
+    double gflops;
+};
+
+// Итог подбора: лучшая конфигурация и все измерения по порядку
+struct autotune_result
+{
+    gemm_config best;
+    double gflops = 0;
+    std::vector<autotune_trial> trials;
+};
+
+// Подбор настройки на матрицах n x n; лучшая конфигурация остаётся текущей (setGemmConfig)
+autotune_result autotuneGemm(std::size_t n, std::size_t repeats = 3);
+
+// Имена раскладок потоков в профиле
+const char* gridName(gemm_grid grid);
+
+// Путь к профилю этой машины
+std::string gemmProfilePath();
+
+// Запись настройки в профиль; false - файл не открылся
+bool saveGemmProfile(const std::string& path, const gemm_config& config);
+
+// Загрузка профиля и setGemmConfig; false - файла нет, он с другой машины или настройка неверна
+bool loadGemmProfile(const std::string& path);
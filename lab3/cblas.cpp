@@ -0,0 +1,112 @@
+/* Реализация cblas_dgemm и dgemm_ через gemmParallel.
+    * Аргументы проверяются в порядке эталонной библиотеки, номер первого неверного - в stderr.
+    * profile_loader - загрузка профиля GEMM_PROFILE при загрузке библиотеки. */
+
+#include "cblas.h"
+#include "gemm.h"
+#include "autotune.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+    struct profile_loader
+    {
+        profile_loader()
+        {
+            if (const char* path = std::getenv("GEMM_PROFILE"))
+                loadGemmProfile(path);
+        }
+    } loader;
+
+    void reportError(const char* routine, int position)
+    {
+        std::fprintf(stderr, " ** On entry to %s parameter number %d had an illegal value\n", routine, position);
+    }
+
+    // Наименьшая допустимая ведущая размерность хранимой матрицы rows x cols
+    int minLd(bool rowMajor, int rows, int cols)
+    {
+        return std::max(1, rowMajor ? cols : rows);
+    }
+
+    // Номер первого неверного размера: M, N, K, lda, ldb, ldc - позиции в списке аргументов
+    int checkSizes(bool rowMajor, bool transA, bool transB, int M, int N, int K, int lda, int ldb, int ldc,
+                   const int (&position)[6])
+    {
+        if (M < 0)
+            return position[0];
+        if (N < 0)
+            return position[1];
+        if (K < 0)
+            return position[2];
+        if (lda < (transA ? minLd(rowMajor, K, M) : minLd(rowMajor, M, K)))
+            return position[3];
+        if (ldb < (transB ? minLd(rowMajor, N, K) : minLd(rowMajor, K, N)))
+            return position[4];
+        if (ldc < minLd(rowMajor, M, N))
+            return position[5];
+        return 0;
+    }
+
+    void run(matrix_layout layout, bool transA, bool transB, int M, int N, int K, double alpha, const double* A,
+             int lda, const double* B, int ldb, double beta, double* C, int ldc)
+    {
+        if (M == 0 || N == 0 || ((alpha == 0 || K == 0) && beta == 1))
+            return; // C не меняется
+
+        // C = op(A) * op(B) в обозначениях gemm.h - A = op(B) * op(C)
+        gemmParallel(layout, transA ? matrix_op::transpose : matrix_op::none,
+                     transB ? matrix_op::transpose : matrix_op::none, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+    }
+}
+
+void cblas_dgemm(CBLAS_ORDER Order, CBLAS_TRANSPOSE TransA, CBLAS_TRANSPOSE TransB, int M, int N, int K,
+                 double alpha, const double* A, int lda, const double* B, int ldb, double beta, double* C, int ldc)
+{
+    auto validTrans = [](CBLAS_TRANSPOSE t) { return t == CblasNoTrans || t == CblasTrans || t == CblasConjTrans; };
+
+    int error = 0;
+    if (Order != CblasRowMajor && Order != CblasColMajor)
+        error = 1;
+    else if (!validTrans(TransA))
+        error = 2;
+    else if (!validTrans(TransB))
+        error = 3;
+    else
+        error = checkSizes(Order == CblasRowMajor, TransA != CblasNoTrans, TransB != CblasNoTrans, M, N, K, lda, ldb,
+                           ldc, {4, 5, 6, 9, 11, 14});
+    if (error)
+    {
+        reportError("cblas_dgemm", error);
+        return;
+    }
+
+    run(Order == CblasRowMajor ? matrix_layout::row_major : matrix_layout::col_major, TransA != CblasNoTrans,
+        TransB != CblasNoTrans, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+void dgemm_(const char* transa, const char* transb, const int* m, const int* n, const int* k, const double* alpha,
+            const double* a, const int* lda, const double* b, const int* ldb, const double* beta, double* c,
+            const int* ldc)
+{
+    const char ta = std::toupper(*transa), tb = std::toupper(*transb);
+    auto validTrans = [](char t) { return t == 'N' || t == 'T' || t == 'C'; };
+
+    int error = 0;
+    if (!validTrans(ta))
+        error = 1;
+    else if (!validTrans(tb))
+        error = 2;
+    else
+        error = checkSizes(false, ta != 'N', tb != 'N', *m, *n, *k, *lda, *ldb, *ldc, {3, 4, 5, 8, 10, 13});
+    if (error)
+    {
+        reportError("DGEMM ", error);
+        return;
+    }
+
+    run(matrix_layout::col_major, ta != 'N', tb != 'N', *m, *n, *k, *alpha, a, *lda, b, *ldb, *beta, c, *ldc);
+}
@@ -0,0 +1,52 @@
+/* Интерфейс BLAS для умножения lab3 - основные моменты:
+    cblas_dgemm и dgemm_ с теми же именами, константами и порядком аргументов, что в CBLAS
+    и эталонном BLAS (Fortran), поэтому библиотеку liblab3blas.so можно подключить вместо
+    -lblas или подменить ею BLAS без пересборки: LD_PRELOAD=liblab3blas.so ./program.
+
+    Обозначения BLAS: C = alpha * op(A) * op(B) + beta * C, op(A) - M x K, op(B) - K x N.
+    В обозначениях gemm.h это A = alpha * op(B) * op(C) + beta * A, вызов - gemmParallel с matrix_layout
+    и matrix_op: транспонирование делает упаковка, копии операндов не создаются.
+
+    Проверка аргументов - как в эталонной библиотеке: при неверном аргументе в stderr выводится его номер,
+    C не изменяется. При beta == 0 исходное содержимое C не читается (NaN в C не попадает в результат).
+    CblasConjTrans для вещественных матриц - то же, что CblasTrans.
+
+    Целые аргументы - int (LP64). При загрузке библиотеки, если задана переменная окружения GEMM_PROFILE,
+    читается профиль настройки gemm (autotune.h). */
+
+#pragma once
+
+// Функции, видимые снаружи библиотеки (остальные символы собираются с -fvisibility=hidden)
+#define LAB3_BLAS_API __attribute__((visibility("default")))
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    enum CBLAS_ORDER
+    {
+        CblasRowMajor = 101,
+        CblasColMajor = 102
+    };
+
+    enum CBLAS_TRANSPOSE
+    {
+        CblasNoTrans = 111,
+        CblasTrans = 112,
+        CblasConjTrans = 113
+    };
+
+    // C = alpha * op(A) * op(B) + beta * C
+    LAB3_BLAS_API void cblas_dgemm(enum CBLAS_ORDER Order, enum CBLAS_TRANSPOSE TransA, enum CBLAS_TRANSPOSE TransB,
+                                   int M, int N, int K, double alpha, const double* A, int lda, const double* B,
+                                   int ldb, double beta, double* C, int ldc);
+
+    // То же в соглашениях Fortran: матрицы по столбцам, аргументы по указателю, transa/transb - 'N', 'T', 'C'
+    LAB3_BLAS_API void dgemm_(const char* transa, const char* transb, const int* m, const int* n, const int* k,
+                              const double* alpha, const double* a, const int* lda, const double* b, const int* ldb,
+                              const double* beta, double* c, const int* ldc);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,309 @@
+/* Реализация планирования и умножения цепочки матриц.
+    * planChain - таблицы cost и split динамическим программированием, затем уровни и буферы пула.
+    * assignSlots - буфер для каждого произведения уровня: наименьший свободный подходящий,
+      иначе наибольший свободный (увеличивается), иначе новый.
+    * multiplyLevel - произведения уровня по очереди или параллельно вложенными командами OpenMP. */
+
+#include "chain.h"
+#include "gemm.h"
+#include <assert.h>
+#include <omp.h>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+namespace
+{
+    // Операций в произведении m x k на k x n
+    double productFlops(std::size_t m, std::size_t n, std::size_t k)
+    {
+        return 2.0 * m * n * k;
+    }
+
+    // Шаг столбцов промежуточного произведения с dims[first] строками
+    std::size_t chainLd(std::size_t rows)
+    {
+        return AlignedMatrix<double>::paddedStride(rows);
+    }
+
+    // Буферы для произведений одного уровня; буферы сомножителей освобождаются после уровня
+    void assignSlots(std::vector<chain_node>& level, const std::vector<std::size_t>& dims,
+                     std::vector<std::size_t>& sizes, std::vector<bool>& busy)
+    {
+        for (chain_node& node : level)
+        {
+            if (node.slot == chain_no_slot) // Последнее произведение пишется сразу в A
+                continue;
+
+            const std::size_t need = chainLd(dims[node.first]) * dims[node.last + 1];
+            std::size_t best = chain_no_slot;
+            for (std::size_t s = 0; s < sizes.size(); s++)
+            {
+                if (busy[s])
+                    continue;
+                if (best == chain_no_slot)
+                {
+                    best = s;
+                    continue;
+                }
+                const bool fits = sizes[s] >= need, bestFits = sizes[best] >= need;
+                if ((fits && (!bestFits || sizes[s] < sizes[best])) || (!fits && !bestFits && sizes[s] > sizes[best]))
+                    best = s;
+            }
+            if (best == chain_no_slot)
+            {
+                best = sizes.size();
+                sizes.push_back(0);
+                busy.push_back(false);
+            }
+            sizes[best] = std::max(sizes[best], need);
+            busy[best] = true;
+            node.slot = best;
+        }
+
+        for (const chain_node& node : level)
+        {
+            for (std::size_t s : {node.left_slot, node.right_slot})
+            {
+                if (s != chain_no_slot)
+                    busy[s] = false;
+            }
+        }
+    }
+
+    // Сомножитель Mfirst..Mlast - исходная матрица или буфер пула
+    struct factor
+    {
+        const double* data;
+        std::size_t ld;
+    };
+
+    void multiplyNode(const chain_plan& plan, const chain_node& node, const std::vector<chain_matrix>& operands,
+                      std::vector<std::vector<double>>& buffers, double* A, std::size_t lda)
+    {
+        const std::vector<std::size_t>& dims = plan.dims;
+        auto get = [&](std::size_t first, std::size_t last, std::size_t slot)
+        {
+            if (first == last)
+                return factor{operands[first].data, operands[first].ld};
+            return factor{buffers[slot].data(), chainLd(dims[first])};
+        };
+
+        const factor left = get(node.first, node.split, node.left_slot);
+        const factor right = get(node.split + 1, node.last, node.right_slot);
+        double* result = A;
+        std::size_t ldr = lda;
+        if (node.slot != chain_no_slot)
+        {
+            result = buffers[node.slot].data();
+            ldr = chainLd(dims[node.first]);
+        }
+        gemmParallel(dims[node.first], dims[node.last + 1], dims[node.split + 1], 1.0, left.data, left.ld,
+                     right.data, right.ld, 0.0, result, ldr);
+    }
+
+    double nodeFlops(const chain_plan& plan, const chain_node& node)
+    {
+        return productFlops(plan.dims[node.first], plan.dims[node.last + 1], plan.dims[node.split + 1]);
+    }
+
+    void multiplyLevel(const chain_plan& plan, const std::vector<chain_node>& level,
+                       const std::vector<chain_matrix>& operands, std::vector<std::vector<double>>& buffers,
+                       double* A, std::size_t lda)
+    {
+        double total = 0, largest = 0;
+        for (const chain_node& node : level)
+        {
+            total += nodeFlops(plan, node);
+            largest = std::max(largest, nodeFlops(plan, node));
+        }
+
+        const std::size_t threads = omp_get_max_threads();
+        if (level.size() == 1 || threads == 1 || omp_in_parallel() || 2 * largest > total)
+        {
+            for (const chain_node& node : level)
+            {
+                multiplyNode(plan, node, operands, buffers, A, lda);
+            }
+            return;
+        }
+
+        // Крупные произведения - первыми, потоки делятся поровну между командами
+        std::vector<const chain_node*> order;
+        for (const chain_node& node : level)
+        {
+            order.push_back(&node);
+        }
+        std::sort(order.begin(), order.end(),
+                  [&](const chain_node* a, const chain_node* b) { return nodeFlops(plan, *a) > nodeFlops(plan, *b); });
+
+        const std::size_t teams = std::min(level.size(), threads);
+        const int levels = omp_get_max_active_levels();
+        omp_set_max_active_levels(std::max(levels, 2));
+
+#pragma omp parallel num_threads(teams)
+        {
+            const std::size_t t = omp_get_thread_num();
+            omp_set_num_threads(threads / teams + (t < threads % teams ? 1 : 0)); // Команда для gemmParallel
+
+#pragma omp for schedule(dynamic, 1)
+            for (std::size_t i = 0; i < order.size(); i++)
+            {
+                multiplyNode(plan, *order[i], operands, buffers, A, lda);
+            }
+        }
+
+        omp_set_max_active_levels(levels);
+    }
+}
+
+chain_matrix chainOperand(const AlignedMatrix<double>& M)
+{
+    return chain_matrix{M.data(), M.cols(), M.rows(), M.stride()};
+}
+
+chain_plan planChain(const std::vector<std::size_t>& dims)
+{
+    assert(dims.size() >= 2);
+    const std::size_t n = dims.size() - 1; // Сомножителей
+
+    chain_plan plan;
+    plan.dims = dims;
+    for (std::size_t i = 1; i < n; i++)
+    {
+        plan.left_to_right_flops += productFlops(dims[0], dims[i + 1], dims[i]);
+    }
+
+    // cost[i * n + j] - операций для Mi..Mj, split - место последнего умножения
+    std::vector<double> cost(n * n, 0);
+    std::vector<std::size_t> split(n * n, 0);
+    for (std::size_t length = 2; length <= n; length++)
+    {
+        for (std::size_t i = 0; i + length <= n; i++)
+        {
+            const std::size_t j = i + length - 1;
+            cost[i * n + j] = std::numeric_limits<double>::infinity();
+            for (std::size_t s = i; s < j; s++)
+            {
+                const double c =
+                    cost[i * n + s] + cost[(s + 1) * n + j] + productFlops(dims[i], dims[j + 1], dims[s + 1]);
+                if (c < cost[i * n + j])
+                {
+                    cost[i * n + j] = c;
+                    split[i * n + j] = s;
+                }
+            }
+        }
+    }
+    plan.flops = cost[n - 1];
+
+    // Узлы по уровням: возвращает уровень Mi..Mj, у исходной матрицы - 0
+    std::function<std::size_t(std::size_t, std::size_t)> build = [&](std::size_t i, std::size_t j) -> std::size_t
+    {
+        if (i == j)
+            return 0;
+        const std::size_t s = split[i * n + j];
+        const std::size_t level = 1 + std::max(build(i, s), build(s + 1, j));
+        if (plan.levels.size() < level)
+            plan.levels.resize(level);
+        plan.levels[level - 1].push_back(chain_node{i, j, s, 0, chain_no_slot, chain_no_slot});
+        return level;
+    };
+    build(0, n - 1);
+    if (plan.levels.empty())
+        return plan; // Один сомножитель - копирование
+
+    // Последний уровень - одно произведение всей цепочки, оно пишется в A
+    plan.levels.back().back().slot = chain_no_slot;
+
+    std::vector<bool> busy;
+    std::vector<std::vector<std::size_t>> slotOf(n, std::vector<std::size_t>(n, chain_no_slot));
+    for (std::vector<chain_node>& level : plan.levels)
+    {
+        for (chain_node& node : level)
+        {
+            if (node.first != node.split)
+                node.left_slot = slotOf[node.first][node.split];
+            if (node.split + 1 != node.last)
+                node.right_slot = slotOf[node.split + 1][node.last];
+        }
+        assignSlots(level, dims, plan.slot_sizes, busy);
+        for (const chain_node& node : level)
+        {
+            slotOf[node.first][node.last] = node.slot;
+        }
+    }
+    return plan;
+}
+
+std::string chainOrder(const chain_plan& plan)
+{
+    const std::size_t n = plan.dims.size() - 1;
+    std::vector<std::size_t> split(n * n, 0);
+    for (const std::vector<chain_node>& level : plan.levels)
+    {
+        for (const chain_node& node : level)
+        {
+            split[node.first * n + node.last] = node.split;
+        }
+    }
+
+    std::function<std::string(std::size_t, std::size_t)> order = [&](std::size_t i, std::size_t j) -> std::string
+    {
+        if (i == j)
+            return "M" + std::to_string(i);
+        const std::size_t s = split[i * n + j];
+        return "(" + order(i, s) + " " + order(s + 1, j) + ")";
+    };
+    return order(0, n - 1);
+}
+
+void multiplyChain(const chain_plan& plan, const std::vector<chain_matrix>& operands, double* A, std::size_t lda,
+                   chain_workspace& workspace)
+{
+    assert(operands.size() + 1 == plan.dims.size());
+    for (std::size_t i = 0; i < operands.size(); i++)
+    {
+        assert(operands[i].rows == plan.dims[i] && operands[i].cols == plan.dims[i + 1]);
+    }
+
+    if (plan.levels.empty()) // Один сомножитель
+    {
+        const chain_matrix& M = operands[0];
+        for (std::size_t j = 0; j < M.cols; j++)
+        {
+            std::memcpy(A + j * lda, M.data + j * M.ld, M.rows * sizeof(double));
+        }
+        return;
+    }
+
+    // Пул увеличивается только при нехватке
+    std::vector<std::vector<double>>& buffers = workspace.buffers;
+    if (buffers.size() < plan.slot_sizes.size())
+        buffers.resize(plan.slot_sizes.size());
+    for (std::size_t s = 0; s < plan.slot_sizes.size(); s++)
+    {
+        if (buffers[s].size() < plan.slot_sizes[s])
+            buffers[s].resize(plan.slot_sizes[s]);
+    }
+
+    for (const std::vector<chain_node>& level : plan.levels)
+    {
+        multiplyLevel(plan, level, operands, buffers, A, lda);
+    }
+}
+
+void multiplyChain(const std::vector<chain_matrix>& operands, double* A, std::size_t lda, chain_workspace& workspace)
+{
+    if (operands.empty()) // Размеры произведения не определены
+        return;
+
+    std::vector<std::size_t> dims;
+    for (const chain_matrix& M : operands)
+    {
+        dims.push_back(M.rows);
+    }
+    dims.push_back(operands.back().cols);
+    multiplyChain(planChain(dims), operands, A, lda, workspace);
+}
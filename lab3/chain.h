@@ -0,0 +1,76 @@
+/* Умножение цепочки матриц - основные моменты:
+    Обозначения как в gemm.h: матрицы по столбцам, ld - ведущая размерность.
+    Цепочка M0 * M1 * ... * M(n-1), Mi - матрица dims[i] x dims[i + 1].
+
+    План (planChain):
+        * порядок скобок - динамическим программированием за O(n^3): cost(i, j) - наименьшее число
+          операций для Mi..Mj, перебирается место последнего умножения s (Mi..Ms) * (Ms+1..Mj);
+          порядок слева направо может стоить на порядки больше (10 x 1000 * 1000 x 10 * 10 x 1000);
+        * промежуточные произведения группируются по уровням: уровень узла - 1 + наибольший уровень
+          его сомножителей, произведения одного уровня друг от друга не зависят;
+        * каждому промежуточному произведению назначается буфер пула: буфер занят с уровня, где
+          произведение считается, до уровня, где оно использовано, потом переходит следующим.
+
+    Вычисление (multiplyChain):
+        * уровни по очереди; на уровне с несколькими произведениями потоки OpenMP делятся между ними
+          (вложенные команды, каждое произведение - gemmParallel на свою часть потоков); если же одно
+          произведение - больше половины работы уровня, все идут по очереди на всей команде;
+        * буферы пула (chain_workspace) увеличиваются при нехватке и переиспользуются между вызовами,
+          столбцы - с шагом AlignedMatrix::paddedStride. */
+
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "../common/aligned_matrix.h"
+
+// Сомножитель цепочки
+struct chain_matrix
+{
+    const double* data;
+    std::size_t rows, cols, ld;
+};
+
+// Сомножитель из выровненной матрицы ("строка" контейнера - столбец)
+chain_matrix chainOperand(const AlignedMatrix<double>& M);
+
+// Нет буфера: сомножитель - исходная матрица, результат - A
+constexpr std::size_t chain_no_slot = static_cast<std::size_t>(-1);
+
+// Произведение Mfirst..Mlast = (Mfirst..Msplit) * (Msplit+1..Mlast)
+struct chain_node
+{
+    std::size_t first, last, split;
+    std::size_t slot;                  // Буфер результата
+    std::size_t left_slot, right_slot; // Буферы сомножителей
+};
+
+// План умножения цепочки
+struct chain_plan
+{
+    std::vector<std::size_t> dims;                // Размерности: Mi - dims[i] x dims[i + 1]
+    std::vector<std::vector<chain_node>> levels;  // Произведения по уровням, последнее - всей цепочки
+    std::vector<std::size_t> slot_sizes;          // Элементов в каждом буфере пула
+    double flops = 0;                             // Операций при найденном порядке
+    double left_to_right_flops = 0;               // Операций при умножении слева направо
+};
+
+// Пул буферов промежуточных произведений
+struct chain_workspace
+{
+    std::vector<std::vector<double>> buffers;
+};
+
+// План для матриц dims[i] x dims[i + 1], i = 0..dims.size() - 2
+chain_plan planChain(const std::vector<std::size_t>& dims);
+
+// Порядок скобок плана, например "((M0 M1) M2)"
+std::string chainOrder(const chain_plan& plan);
+
+// A = M0 * M1 * ... по готовому плану; размеры сомножителей должны совпадать с plan.dims
+void multiplyChain(const chain_plan& plan, const std::vector<chain_matrix>& operands, double* A, std::size_t lda,
+                   chain_workspace& workspace);
+
+// То же с планом по размерам сомножителей; пустой список сомножителей A не меняет
+void multiplyChain(const std::vector<chain_matrix>& operands, double* A, std::size_t lda,
+                   chain_workspace& workspace);
@@ -0,0 +1,636 @@
+/* Реализация блочного умножения с упаковкой панелей (AVX-512 или AVX2 + FMA).
+    * vec<T> - операции над регистром для double и float, MR x NR - тайл микроядра (shapes - набор форм).
+    * packB / packC - упаковка блоков в микропанели, microKernel - тайл в регистрах,
+      macroKernel - обход микропанелей упакованных блоков.
+    * gemmParallel - общий упакованный блок C и сетка макротайлов по потокам OpenMP. */
+
+#include "gemm.h"
+#include <immintrin.h>
+#include <omp.h>
+#include <algorithm>
+#include <cassert>
+#include <new>
+#include <unistd.h>
+
+namespace
+{
+    // Операции над регистром для типа элемента T
+    template <class T>
+    struct vec;
+
+#ifdef __AVX512F__
+    template <>
+    struct vec<double>
+    {
+        using type = __m512d;
+        static constexpr std::size_t lanes = 8;
+        static __m512d zero() { return _mm512_setzero_pd(); }
+        static __m512d set1(double v) { return _mm512_set1_pd(v); }
+        static __m512d load(const double* p) { return _mm512_loadu_pd(p); }
+        static void store(double* p, __m512d v) { _mm512_storeu_pd(p, v); }
+        static __m512d mul(__m512d a, __m512d b) { return _mm512_mul_pd(a, b); }
+        static __m512d fmadd(__m512d a, __m512d b, __m512d c) { return _mm512_fmadd_pd(a, b, c); }
+    };
+
+    template <>
+    struct vec<float>
+    {
+        using type = __m512;
+        static constexpr std::size_t lanes = 16;
+        static __m512 zero() { return _mm512_setzero_ps(); }
+        static __m512 set1(float v) { return _mm512_set1_ps(v); }
+        static __m512 load(const float* p) { return _mm512_loadu_ps(p); }
+        static void store(float* p, __m512 v) { _mm512_storeu_ps(p, v); }
+        static __m512 mul(__m512 a, __m512 b) { return _mm512_mul_ps(a, b); }
+        static __m512 fmadd(__m512 a, __m512 b, __m512 c) { return _mm512_fmadd_ps(a, b, c); }
+    };
+
+    // Формы микроядер: регистров в столбце тайла и столбцов тайла; аккумуляторы + столбец B + broadcast <= 32
+    constexpr std::size_t shapes[][2] = {{2, 14}, {1, 24}, {3, 8}};
+#else
+    template <>
+    struct vec<double>
+    {
+        using type = __m256d;
+        static constexpr std::size_t lanes = 4;
+        static __m256d zero() { return _mm256_setzero_pd(); }
+        static __m256d set1(double v) { return _mm256_set1_pd(v); }
+        static __m256d load(const double* p) { return _mm256_loadu_pd(p); }
+        static void store(double* p, __m256d v) { _mm256_storeu_pd(p, v); }
+        static __m256d mul(__m256d a, __m256d b) { return _mm256_mul_pd(a, b); }
+        static __m256d fmadd(__m256d a, __m256d b, __m256d c) { return _mm256_fmadd_pd(a, b, c); }
+    };
+
+    template <>
+    struct vec<float>
+    {
+        using type = __m256;
+        static constexpr std::size_t lanes = 8;
+        static __m256 zero() { return _mm256_setzero_ps(); }
+        static __m256 set1(float v) { return _mm256_set1_ps(v); }
+        static __m256 load(const float* p) { return _mm256_loadu_ps(p); }
+        static void store(float* p, __m256 v) { _mm256_storeu_ps(p, v); }
+        static __m256 mul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+        static __m256 fmadd(__m256 a, __m256 b, __m256 c) { return _mm256_fmadd_ps(a, b, c); }
+    };
+
+    // Формы микроядер для 16 регистров ymm
+    constexpr std::size_t shapes[][2] = {{2, 6}, {1, 12}, {3, 4}};
+#endif
+    constexpr std::size_t shape_count = sizeof(shapes) / sizeof(shapes[0]);
+
+    // Буфер упаковки, выровненный на 64 байта; у каждого потока свой
+    struct pack_buffer
+    {
+        void* data = nullptr;
+        std::size_t capacity = 0; // Байт
+
+        template <class T>
+        T* reserve(std::size_t n)
+        {
+            if (n * sizeof(T) > capacity)
+            {
+                ::operator delete[](data, std::align_val_t{64});
+                data = ::operator new[](n * sizeof(T), std::align_val_t{64});
+                capacity = n * sizeof(T);
+            }
+            return static_cast<T*>(data);
+        }
+
+        ~pack_buffer() { ::operator delete[](data, std::align_val_t{64}); }
+    };
+
+    // Блок B (mc x kc) -> микропанели по mr строк: для каждого p подряд mr элементов столбца p.
+    // transposed - в памяти лежит B^T: элемент (i, p) по адресу B[i * ldb + p]
+    template <class T, std::size_t MR>
+    void packB(std::size_t mc, std::size_t kc, const T* B, std::size_t ldb, bool transposed, T* buffer)
+    {
+        for (std::size_t ir = 0; ir < mc; ir += MR)
+        {
+            const std::size_t rows = std::min(MR, mc - ir);
+            if (transposed)
+            {
+                for (std::size_t ii = 0; ii < MR; ii++) // Строка B - подряд в памяти
+                {
+                    const T* source = B + (ir + ii) * ldb;
+                    for (std::size_t p = 0; p < kc; p++)
+                    {
+                        buffer[p * MR + ii] = ii < rows ? source[p] : 0;
+                    }
+                }
+                buffer += kc * MR;
+                continue;
+            }
+
+            for (std::size_t p = 0; p < kc; p++)
+            {
+                const T* source = B + p * ldb + ir;
+                std::size_t ii = 0;
+                for (; ii < rows; ii++)
+                {
+                    *buffer++ = source[ii];
+                }
+                for (; ii < MR; ii++) // Дополнение края нулями
+                {
+                    *buffer++ = 0;
+                }
+            }
+        }
+    }
+
+    // Блок C (kc x nc) -> микропанели по nr столбцов: для каждого p подряд nr элементов строки p.
+    // transposed - в памяти лежит C^T: элемент (p, j) по адресу C[p * ldc + j]
+    template <class T, std::size_t NR>
+    void packC(std::size_t kc, std::size_t nc, const T* C, std::size_t ldc, bool transposed, T* buffer)
+    {
+        for (std::size_t jr = 0; jr < nc; jr += NR)
+        {
+            const std::size_t cols = std::min(NR, nc - jr);
+            if (transposed)
+            {
+                for (std::size_t p = 0; p < kc; p++) // Строка C - подряд в памяти
+                {
+                    const T* source = C + p * ldc + jr;
+                    for (std::size_t jj = 0; jj < NR; jj++)
+                    {
+                        buffer[p * NR + jj] = jj < cols ? source[jj] : 0;
+                    }
+                }
+            }
+            else
+            {
+                for (std::size_t jj = 0; jj < NR; jj++)
+                {
+                    const T* source = C + (jr + jj) * ldc;
+                    for (std::size_t p = 0; p < kc; p++)
+                    {
+                        buffer[p * NR + jj] = jj < cols ? source[p] : 0;
+                    }
+                }
+            }
+            buffer += kc * NR;
+        }
+    }
+
+    // Тайл MR x NR: out = alpha * (панель a) * (панель b) + beta * out
+    template <class T, std::size_t MR, std::size_t NR>
+    void microKernel(std::size_t kc, const T* a, const T* b, T* out, std::size_t ld, T alpha, T beta)
+    {
+        using V = vec<T>;
+        constexpr std::size_t R = MR / V::lanes; // Регистров на столбец тайла
+        typename V::type acc[NR][R];
+#pragma GCC unroll 32
+        for (std::size_t j = 0; j < NR; j++)
+        {
+#pragma GCC unroll 4
+            for (std::size_t r = 0; r < R; r++)
+            {
+                acc[j][r] = V::zero();
+            }
+        }
+
+        for (std::size_t p = 0; p < kc; p++)
+        {
+            typename V::type x[R];
+#pragma GCC unroll 4
+            for (std::size_t r = 0; r < R; r++)
+            {
+                x[r] = V::load(a + r * V::lanes);
+            }
+#pragma GCC unroll 32
+            for (std::size_t j = 0; j < NR; j++)
+            {
+                const typename V::type y = V::set1(b[j]);
+#pragma GCC unroll 4
+                for (std::size_t r = 0; r < R; r++)
+                {
+                    acc[j][r] = V::fmadd(x[r], y, acc[j][r]);
+                }
+            }
+            a += MR;
+            b += NR;
+        }
+
+        const typename V::type va = V::set1(alpha), vb = V::set1(beta);
+#pragma GCC unroll 32
+        for (std::size_t j = 0; j < NR; j++)
+        {
+#pragma GCC unroll 4
+            for (std::size_t r = 0; r < R; r++)
+            {
+                T* column = out + j * ld + r * V::lanes;
+                if (beta == 0)
+                    V::store(column, V::mul(va, acc[j][r]));
+                else
+                    V::store(column, V::fmadd(va, acc[j][r], V::mul(vb, V::load(column))));
+            }
+        }
+    }
+
+    // Обход упакованных блоков: A (mc x nc) = alpha * Bp * Cp + beta * A
+    template <class T, std::size_t MR, std::size_t NR>
+    void macroKernel(std::size_t mc, std::size_t nc, std::size_t kc, T alpha, const T* packedB, const T* packedC,
+                     T beta, T* A, std::size_t lda)
+    {
+        for (std::size_t jr = 0; jr < nc; jr += NR)
+        {
+            const std::size_t cols = std::min(NR, nc - jr);
+            for (std::size_t ir = 0; ir < mc; ir += MR)
+            {
+                const std::size_t rows = std::min(MR, mc - ir);
+                const T* a = packedB + ir * kc;
+                const T* b = packedC + jr * kc;
+                T* out = A + jr * lda + ir;
+
+                if (rows == MR && cols == NR)
+                {
+                    microKernel<T, MR, NR>(kc, a, b, out, lda, alpha, beta);
+                    continue;
+                }
+
+                // Неполный тайл на краю: считаем целиком во временный буфер и копируем нужную часть
+                alignas(64) T tile[MR * NR];
+                microKernel<T, MR, NR>(kc, a, b, tile, MR, 1, 0);
+                for (std::size_t j = 0; j < cols; j++)
+                {
+                    for (std::size_t i = 0; i < rows; i++)
+                    {
+                        T& value = out[j * lda + i];
+                        value = beta == 0 ? alpha * tile[j * MR + i] : alpha * tile[j * MR + i] + beta * value;
+                    }
+                }
+            }
+        }
+    }
+
+    // Сетка потоков Tm x Tn для блока m x n: делитель T с наименьшим периметром макротайла
+    // или, если задано в настройке, деление только по строкам или только по столбцам
+    struct thread_grid
+    {
+        std::size_t rows, cols;
+    };
+
+    thread_grid threadGrid(std::size_t T, std::size_t m, std::size_t n, gemm_grid mode)
+    {
+        if (mode == gemm_grid::rows)
+            return thread_grid{T, 1};
+        if (mode == gemm_grid::cols)
+            return thread_grid{1, T};
+
+        thread_grid best{T, 1};
+        double bestPerimeter = -1;
+        for (std::size_t cols = 1; cols <= T; cols++)
+        {
+            if (T % cols != 0)
+                continue;
+            const double perimeter = static_cast<double>(m) / (T / cols) + static_cast<double>(n) / cols;
+            if (bestPerimeter < 0 || perimeter < bestPerimeter)
+            {
+                best = thread_grid{T / cols, cols};
+                bestPerimeter = perimeter;
+            }
+        }
+        return best;
+    }
+
+    // Часть i из parts диапазона [0, count) единиц размера unit, не выходящая за total
+    struct unit_range
+    {
+        std::size_t b, e;
+    };
+
+    unit_range unitRange(std::size_t total, std::size_t unit, std::size_t parts, std::size_t i)
+    {
+        const std::size_t count = (total + unit - 1) / unit;
+        return unit_range{std::min(total, count * i / parts * unit), std::min(total, count * (i + 1) / parts * unit)};
+    }
+
+    // Операнд умножения: элемент (i, j) - data[j * ld + i], при transposed - data[i * ld + j]
+    template <class T>
+    struct operand
+    {
+        const T* data;
+        std::size_t ld;
+        bool transposed;
+
+        const T* at(std::size_t i, std::size_t j) const { return transposed ? data + i * ld + j : data + j * ld + i; }
+    };
+
+    std::size_t cacheSize(int name, std::size_t fallback)
+    {
+        const long size = sysconf(name);
+        return size > 0 ? static_cast<std::size_t>(size) : fallback;
+    }
+
+    // Размеры блоков в элементах T для тайла m x nr: доли кэшей одинаковы, для float блоки по k вдвое длиннее
+    template <class T>
+    gemm_blocking cacheBlocking(std::size_t m, std::size_t nr)
+    {
+        const std::size_t l1 = cacheSize(_SC_LEVEL1_DCACHE_SIZE, 32 << 10);
+        const std::size_t l2 = cacheSize(_SC_LEVEL2_CACHE_SIZE, 1 << 20);
+        const std::size_t l3 = cacheSize(_SC_LEVEL3_CACHE_SIZE, 8 << 20);
+
+        gemm_blocking blocking;
+        blocking.kc = std::clamp<std::size_t>(l1 / 2 / (nr * sizeof(T)) / 8 * 8, 64, 4096 / sizeof(T));
+        blocking.mc = std::clamp<std::size_t>(l2 / 2 / (blocking.kc * sizeof(T)) / m * m, m, 1024 / m * m);
+        blocking.nc = std::clamp<std::size_t>(l3 / 2 / (blocking.kc * sizeof(T)) / nr * nr, nr, 4096 / nr * nr);
+        return blocking;
+    }
+
+    template <class T, std::size_t MR, std::size_t NR>
+    void gemmBlocked(std::size_t m, std::size_t n, std::size_t k, T alpha, operand<T> B, operand<T> C, T beta, T* A,
+                     std::size_t lda, const gemm_blocking& blocking)
+    {
+        if (m == 0 || n == 0)
+            return;
+
+        if (k == 0 || alpha == 0) // Произведение не участвует: A = beta * A
+        {
+            for (std::size_t j = 0; j < n; j++)
+            {
+                for (std::size_t i = 0; i < m; i++)
+                {
+                    A[j * lda + i] = beta == 0 ? 0 : beta * A[j * lda + i];
+                }
+            }
+            return;
+        }
+
+        const std::size_t mc = std::max(MR, blocking.mc / MR * MR);
+        const std::size_t nc = std::max(NR, blocking.nc / NR * NR);
+        const std::size_t kc = std::max<std::size_t>(1, blocking.kc);
+
+        thread_local pack_buffer bufferB, bufferC;
+        T* packedB = bufferB.reserve<T>(mc * kc);
+        T* packedC = bufferC.reserve<T>(nc * kc);
+
+        for (std::size_t jc = 0; jc < n; jc += nc)
+        {
+            const std::size_t ncCur = std::min(nc, n - jc);
+            for (std::size_t pc = 0; pc < k; pc += kc)
+            {
+                const std::size_t kcCur = std::min(kc, k - pc);
+                const T betaCur = pc == 0 ? beta : 1; // Следующие блоки по k добавляются к результату
+
+                packC<T, NR>(kcCur, ncCur, C.at(pc, jc), C.ld, C.transposed, packedC);
+                for (std::size_t ic = 0; ic < m; ic += mc)
+                {
+                    const std::size_t mcCur = std::min(mc, m - ic);
+                    packB<T, MR>(mcCur, kcCur, B.at(ic, pc), B.ld, B.transposed, packedB);
+                    macroKernel<T, MR, NR>(mcCur, ncCur, kcCur, alpha, packedB, packedC, betaCur, A + jc * lda + ic, lda);
+                }
+            }
+        }
+    }
+
+    template <class T, std::size_t MR, std::size_t NR>
+    void gemmTeam(std::size_t m, std::size_t n, std::size_t k, T alpha, operand<T> B, operand<T> C, T beta, T* A,
+                  std::size_t lda, const gemm_blocking& blocking, gemm_grid mode)
+    {
+        if (m == 0 || n == 0 || k == 0 || alpha == 0)
+        {
+            gemmBlocked<T, MR, NR>(m, n, k, alpha, B, C, beta, A, lda, blocking); // Только масштабирование A
+            return;
+        }
+
+        const std::size_t mc = std::max(MR, blocking.mc / MR * MR);
+        const std::size_t nc = std::max(NR, blocking.nc / NR * NR);
+        const std::size_t kc = std::max<std::size_t>(1, blocking.kc);
+
+        pack_buffer shared; // Упакованный блок C, общий для всех потоков
+        T* packedC = shared.reserve<T>(nc * kc);
+
+#pragma omp parallel
+        {
+            const std::size_t threads = omp_get_num_threads(), t = omp_get_thread_num();
+            const thread_grid grid = threadGrid(threads, m, std::min(n, nc), mode);
+            const std::size_t tm = t / grid.cols, tn = t % grid.cols; // Место потока в сетке
+
+            thread_local pack_buffer bufferB;
+            T* packedB = bufferB.reserve<T>(mc * kc);
+            const auto [rb, re] = unitRange(m, MR, grid.rows, tm); // Строки макротайла потока
+
+            for (std::size_t jc = 0; jc < n; jc += nc)
+            {
+                const std::size_t ncCur = std::min(nc, n - jc);
+                const auto [cb, ce] = unitRange(ncCur, NR, grid.cols, tn); // Столбцы макротайла потока
+                const auto [pb, pe] = unitRange(ncCur, NR, threads, t);     // Микропанели C, которые пакует поток
+
+                for (std::size_t pc = 0; pc < k; pc += kc)
+                {
+                    const std::size_t kcCur = std::min(kc, k - pc);
+                    const T betaCur = pc == 0 ? beta : 1;
+
+                    if (pb < pe)
+                        packC<T, NR>(kcCur, pe - pb, C.at(pc, jc + pb), C.ld, C.transposed, packedC + pb * kcCur);
+#pragma omp barrier // Блок C упакован целиком
+
+                    for (std::size_t ic = rb; ic < re && cb < ce; ic += mc)
+                    {
+                        const std::size_t mcCur = std::min(mc, re - ic);
+                        packB<T, MR>(mcCur, kcCur, B.at(ic, pc), B.ld, B.transposed, packedB);
+                        macroKernel<T, MR, NR>(mcCur, ce - cb, kcCur, alpha, packedB, packedC + cb * kcCur, betaCur,
+                                    A + (jc + cb) * lda + ic, lda);
+                    }
+#pragma omp barrier // Все потоки закончили с блоком C, его можно перезаписывать
+                }
+            }
+        }
+    }
+
+    // Микроядро из набора shapes с последовательным и многопоточным обходом
+    template <class T>
+    struct kernel_entry
+    {
+        std::size_t mr, nr;
+        void (*serial)(std::size_t, std::size_t, std::size_t, T, operand<T>, operand<T>, T, T*, std::size_t,
+                       const gemm_blocking&);
+        void (*team)(std::size_t, std::size_t, std::size_t, T, operand<T>, operand<T>, T, T*, std::size_t,
+                     const gemm_blocking&, gemm_grid);
+    };
+
+    template <class T, std::size_t I>
+    constexpr kernel_entry<T> entry()
+    {
+        constexpr std::size_t MR = shapes[I][0] * vec<T>::lanes, NR = shapes[I][1];
+        return kernel_entry<T>{MR, NR, &gemmBlocked<T, MR, NR>, &gemmTeam<T, MR, NR>};
+    }
+
+    template <class T>
+    constexpr kernel_entry<T> kernels[shape_count] = {entry<T, 0>(), entry<T, 1>(), entry<T, 2>()};
+
+    // Текущая настройка и номер её микроядра; float использует ту же форму регистров
+    struct active_config
+    {
+        gemm_config config;
+        std::size_t index;
+        gemm_blocking floatBlocking;
+    };
+
+    active_config& active()
+    {
+        static active_config current{gemmDefaultConfig(), 0,
+                                     cacheBlocking<float>(kernels<float>[0].mr, kernels<float>[0].nr)};
+        return current;
+    }
+
+    // Операнды в порядке хранения по столбцам
+    template <class T>
+    struct col_major_call
+    {
+        std::size_t m, n;
+        operand<T> B, C;
+    };
+
+    template <class T>
+    col_major_call<T> colMajor(matrix_layout layout, matrix_op opB, matrix_op opC, std::size_t m, std::size_t n,
+                               const T* B, std::size_t ldb, const T* C, std::size_t ldc)
+    {
+        const operand<T> b{B, ldb, opB == matrix_op::transpose}, c{C, ldc, opC == matrix_op::transpose};
+
+        // По строкам лежат транспонированные матрицы: A^T = op(C)^T * op(B)^T с теми же флагами
+        if (layout == matrix_layout::col_major)
+            return col_major_call<T>{m, n, b, c};
+        return col_major_call<T>{n, m, c, b};
+    }
+}
+
+std::vector<gemm_kernel> gemmKernels()
+{
+    std::vector<gemm_kernel> list;
+    for (const kernel_entry<double>& kernel : kernels<double>)
+    {
+        list.push_back(gemm_kernel{kernel.mr, kernel.nr});
+    }
+    return list;
+}
+
+gemm_config gemmDefaultConfig()
+{
+    const gemm_kernel kernel{kernels<double>[0].mr, kernels<double>[0].nr};
+    return gemm_config{cacheBlocking<double>(kernel.mr, kernel.nr), kernel, gemm_grid::automatic};
+}
+
+const gemm_config& gemmConfig()
+{
+    return active().config;
+}
+
+bool setGemmConfig(const gemm_config& config)
+{
+    const gemm_blocking& b = config.blocking;
+    if (config.kernel.mr == 0 || config.kernel.nr == 0 || b.kc == 0 || b.mc == 0 || b.nc == 0 ||
+        b.mc % config.kernel.mr != 0 || b.nc % config.kernel.nr != 0)
+        return false;
+
+    for (std::size_t i = 0; i < shape_count; i++)
+    {
+        if (kernels<double>[i].mr == config.kernel.mr && kernels<double>[i].nr == config.kernel.nr)
+        {
+            active() = active_config{config, i, cacheBlocking<float>(kernels<float>[i].mr, kernels<float>[i].nr)};
+            return true;
+        }
+    }
+    return false; // Такого микроядра в этой сборке нет
+}
+
+std::size_t gemmMr()
+{
+    return gemmConfig().kernel.mr;
+}
+
+std::size_t gemmNr()
+{
+    return gemmConfig().kernel.nr;
+}
+
+gemm_blocking gemmBlocking()
+{
+    return cacheBlocking<double>(gemmMr(), gemmNr());
+}
+
+gemm_blocking gemmBlocking(const gemm_kernel& kernel)
+{
+    return cacheBlocking<double>(kernel.mr, kernel.nr);
+}
+
+void gemm(std::size_t m, std::size_t n, std::size_t k, double alpha, const double* B, std::size_t ldb,
+          const double* C, std::size_t ldc, double beta, double* A, std::size_t lda)
+{
+    gemm(m, n, k, alpha, B, ldb, C, ldc, beta, A, lda, gemmConfig().blocking);
+}
+
+void gemm(std::size_t m, std::size_t n, std::size_t k, double alpha, const double* B, std::size_t ldb,
+          const double* C, std::size_t ldc, double beta, double* A, std::size_t lda, const gemm_blocking& blocking)
+{
+    kernels<double>[active().index].serial(m, n, k, alpha, operand<double>{B, ldb, false},
+                                           operand<double>{C, ldc, false}, beta, A, lda, blocking);
+}
+
+void gemm(matrix_layout layout, matrix_op opB, matrix_op opC, std::size_t m, std::size_t n, std::size_t k,
+          double alpha, const double* B, std::size_t ldb, const double* C, std::size_t ldc, double beta, double* A,
+          std::size_t lda)
+{
+    const active_config& current = active();
+    const col_major_call<double> call = colMajor(layout, opB, opC, m, n, B, ldb, C, ldc);
+    kernels<double>[current.index].serial(call.m, call.n, k, alpha, call.B, call.C, beta, A, lda,
+                                          current.config.blocking);
+}
+
+void gemm(std::size_t m, std::size_t n, std::size_t k, float alpha, const float* B, std::size_t ldb, const float* C,
+          std::size_t ldc, float beta, float* A, std::size_t lda)
+{
+    const active_config& current = active();
+    kernels<float>[current.index].serial(m, n, k, alpha, operand<float>{B, ldb, false}, operand<float>{C, ldc, false},
+                                         beta, A, lda, current.floatBlocking);
+}
+
+void gemmParallel(std::size_t m, std::size_t n, std::size_t k, double alpha, const double* B, std::size_t ldb,
+                  const double* C, std::size_t ldc, double beta, double* A, std::size_t lda)
+{
+    gemmParallel(matrix_layout::col_major, matrix_op::none, matrix_op::none, m, n, k, alpha, B, ldb, C, ldc, beta,
+                 A, lda);
+}
+
+void gemmParallel(matrix_layout layout, matrix_op opB, matrix_op opC, std::size_t m, std::size_t n, std::size_t k,
+                  double alpha, const double* B, std::size_t ldb, const double* C, std::size_t ldc, double beta,
+                  double* A, std::size_t lda)
+{
+    const active_config& current = active();
+    const col_major_call<double> call = colMajor(layout, opB, opC, m, n, B, ldb, C, ldc);
+    kernels<double>[current.index].team(call.m, call.n, k, alpha, call.B, call.C, beta, A, lda,
+                                        current.config.blocking, current.config.grid);
+}
+
+void gemmParallel(std::size_t m, std::size_t n, std::size_t k, float alpha, const float* B, std::size_t ldb,
+                  const float* C, std::size_t ldc, float beta, float* A, std::size_t lda)
+{
+    const active_config& current = active();
+    kernels<float>[current.index].team(m, n, k, alpha, operand<float>{B, ldb, false}, operand<float>{C, ldc, false},
+                                       beta, A, lda, current.floatBlocking, current.config.grid);
+}
+
+void mulMatrixPacked(double* A, const double* B, const double* C, std::size_t cA, std::size_t rA, std::size_t cB,
+                     std::size_t rB, std::size_t cC, std::size_t rC)
+{
+    assert(cB == rC && cA == cC && rA == rB);
+    gemm(rA, cA, cB, 1, B, rB, C, rC, 0, A, rA);
+}
+
+void mulMatrixPacked(AlignedMatrix<double>& A, const AlignedMatrix<double>& B, const AlignedMatrix<double>& C)
+{
+    // cols() контейнера - количество строк матрицы, rows() - количество столбцов
+    gemm(A.cols(), A.rows(), B.rows(), 1, B.data(), B.stride(), C.data(), C.stride(), 0, A.data(), A.stride());
+}
+
+void mulMatrixParallel(AlignedMatrix<double>& A, const AlignedMatrix<double>& B, const AlignedMatrix<double>& C)
+{
+    gemmParallel(A.cols(), A.rows(), B.rows(), 1, B.data(), B.stride(), C.data(), C.stride(), 0, A.data(),
+                 A.stride());
+}
+
+void mulMatrixParallel(AlignedMatrix<float>& A, const AlignedMatrix<float>& B, const AlignedMatrix<float>& C)
+{
+    gemmParallel(A.cols(), A.rows(), B.rows(), 1.0f, B.data(), B.stride(), C.data(), C.stride(), 0.0f, A.data(),
+                 A.stride());
+}
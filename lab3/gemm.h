@@ -0,0 +1,155 @@
+/* Блочное умножение матриц с упаковкой панелей (схема GotoBLAS) - основные моменты:
+    Все матрицы хранятся по столбцам, как в main.cpp: A = alpha * B * C + beta * A,
+    B - m x k, C - k x n, A - m x n, ld* - ведущие размерности (шаг столбцов).
+
+    Пять вложенных циклов:
+        * jc: столбцы C и A блоками по nc;
+        * pc: общая размерность блоками по kc - блок C (kc x nc) упаковывается в буфер для L3;
+        * ic: строки B и A блоками по mc - блок B (mc x kc) упаковывается в буфер для L2;
+        * jr, ir: микропанели nr столбцов C и mr строк B, микроядро считает тайл A размером mr x nr.
+
+    Упаковка:
+        Блок B переписывается микропанелями по mr строк, блок C - микропанелями по nr столбцов:
+        микроядро читает обе панели подряд, без шагов по ld. Края дополняются нулями.
+
+    Микроядро:
+        Тайл A держится в регистрах целиком: на каждом шаге по k загружаются mr элементов столбца B
+        (R регистров) и для каждого из nr столбцов C делается broadcast и R FMA.
+        * AVX-512: 16 x 14 (по умолчанию), 8 x 24, 24 x 8 - до 28 аккумуляторов zmm из 32;
+        * AVX2:    8 x 6 (по умолчанию),   4 x 12, 12 x 4 - 12 аккумуляторов ymm из 16.
+        Форма выбирается во время выполнения (gemm_config), все три собираются заранее.
+
+    Размеры блоков по умолчанию считаются из размеров кэшей (gemmBlocking):
+        панель C (kc x nr) занимает половину L1, блок B (mc x kc) - половину L2,
+        блок C (kc x nc) - половину L3.
+
+    Настройка (gemm_config - блоки, форма микроядра, раскладка потоков) общая для всех вызовов gemm
+    и gemmParallel без явных блоков; её подбирает и сохраняет в профиль autotune.h.
+
+    Многопоточный вариант (gemmParallel):
+        * Упакованный блок C общий для всей команды потоков OpenMP: потоки пакуют его вместе
+          (каждый - свою часть микропанелей), затем барьер. Для нескольких сокетов команду стоит
+          закрепить за одним сокетом (OMP_PLACES=sockets) - тогда общий блок лежит в его L3.
+        * Блок A (m x nc) делится на Tm x Tn макротайлов по сетке потоков: строки - кратно mr,
+          столбцы - целыми микропанелями. Сетка выбирается с наименьшим периметром тайла,
+          то есть с наименьшим объёмом упаковки на поток.
+        * Каждый поток пакует в свой буфер блоки B для своих строк и считает свой макротайл.
+
+    Одинарная точность (перегрузки для float):
+        Те же упаковка и обход, микроядро с mr = 32 (AVX-512) или 16 (AVX2): вдвое больше элементов
+        на одну FMA и вдвое меньше байт на элемент; размеры блоков в байтах те же, что для double.
+
+    Расположение и транспонирование (перегрузки с matrix_layout и matrix_op, как в CBLAS):
+        * op(B), op(C) - сами матрицы или транспонированные, транспонирование делает упаковка:
+          микропанели собираются из строк вместо столбцов, копия операнда не создаётся;
+        * матрица по строкам - та же память, что транспонированная по столбцам, поэтому
+          A = op(B) * op(C) по строкам считается как A^T = op(C)^T * op(B)^T по столбцам. */
+
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "../common/aligned_matrix.h"
+
+// Порядок хранения матриц
+enum class matrix_layout
+{
+    col_major, // Элемент (i, j) - data[j * ld + i]
+    row_major  // Элемент (i, j) - data[i * ld + j]
+};
+
+// Операция над операндом
+enum class matrix_op
+{
+    none,
+    transpose
+};
+
+// Размеры блоков
+struct gemm_blocking
+{
+    std::size_t mc; // Строк B в блоке (кратно mr)
+    std::size_t kc; // Общая размерность блока
+    std::size_t nc; // Столбцов C в блоке (кратно nr)
+};
+
+// Раскладка потоков по макротайлам
+enum class gemm_grid
+{
+    automatic, // Сетка с наименьшим периметром макротайла
+    rows,      // Только по строкам A
+    cols       // Только по столбцам A
+};
+
+// Форма микроядра - тайл mr x nr
+struct gemm_kernel
+{
+    std::size_t mr, nr;
+};
+
+// Настройка умножения
+struct gemm_config
+{
+    gemm_blocking blocking;
+    gemm_kernel kernel;
+    gemm_grid grid = gemm_grid::automatic;
+};
+
+// Формы микроядер этой сборки, первая - по умолчанию
+std::vector<gemm_kernel> gemmKernels();
+
+// Первое микроядро и блоки по размерам кэшей
+gemm_config gemmDefaultConfig();
+
+// Текущая настройка и её замена; false - такой формы микроядра нет или блоки не кратны ей,
+// настройка не изменилась
+const gemm_config& gemmConfig();
+bool setGemmConfig(const gemm_config& config);
+
+// Размер тайла текущего микроядра
+std::size_t gemmMr();
+std::size_t gemmNr();
+
+// Размеры блоков по размерам кэшей процессора для текущего микроядра
+gemm_blocking gemmBlocking();
+
+// То же для заданного микроядра
+gemm_blocking gemmBlocking(const gemm_kernel& kernel);
+
+// A = alpha * B * C + beta * A (по столбцам); при beta == 0 исходное содержимое A не читается
+void gemm(std::size_t m, std::size_t n, std::size_t k, double alpha, const double* B, std::size_t ldb,
+          const double* C, std::size_t ldc, double beta, double* A, std::size_t lda);
+
+// То же с заданными размерами блоков
+void gemm(std::size_t m, std::size_t n, std::size_t k, double alpha, const double* B, std::size_t ldb,
+          const double* C, std::size_t ldc, double beta, double* A, std::size_t lda, const gemm_blocking& blocking);
+
+// A = alpha * op(B) * op(C) + beta * A в заданном порядке хранения; op(B) - m x k, op(C) - k x n
+void gemm(matrix_layout layout, matrix_op opB, matrix_op opC, std::size_t m, std::size_t n, std::size_t k,
+          double alpha, const double* B, std::size_t ldb, const double* C, std::size_t ldc, double beta, double* A,
+          std::size_t lda);
+
+// Многопоточное умножение A = alpha * B * C + beta * A (потоки OpenMP)
+void gemmParallel(std::size_t m, std::size_t n, std::size_t k, double alpha, const double* B, std::size_t ldb,
+                  const double* C, std::size_t ldc, double beta, double* A, std::size_t lda);
+
+// Многопоточное A = alpha * op(B) * op(C) + beta * A в заданном порядке хранения
+void gemmParallel(matrix_layout layout, matrix_op opB, matrix_op opC, std::size_t m, std::size_t n, std::size_t k,
+                  double alpha, const double* B, std::size_t ldb, const double* C, std::size_t ldc, double beta,
+                  double* A, std::size_t lda);
+
+// Одинарная точность
+void gemm(std::size_t m, std::size_t n, std::size_t k, float alpha, const float* B, std::size_t ldb, const float* C,
+          std::size_t ldc, float beta, float* A, std::size_t lda);
+void gemmParallel(std::size_t m, std::size_t n, std::size_t k, float alpha, const float* B, std::size_t ldb,
+                  const float* C, std::size_t ldc, float beta, float* A, std::size_t lda);
+
+// Умножение с упаковкой в тех же обозначениях, что и mulMatrix256
+void mulMatrixPacked(double* A, const double* B, const double* C, std::size_t cA, std::size_t rA, std::size_t cB,
+                     std::size_t rB, std::size_t cC, std::size_t rC);
+
+// Умножение выровненных матриц (строка контейнера - столбец матрицы, шаг столбцов - stride)
+void mulMatrixPacked(AlignedMatrix<double>& A, const AlignedMatrix<double>& B, const AlignedMatrix<double>& C);
+
+// Многопоточное умножение выровненных матриц
+void mulMatrixParallel(AlignedMatrix<double>& A, const AlignedMatrix<double>& B, const AlignedMatrix<double>& C);
+void mulMatrixParallel(AlignedMatrix<float>& A, const AlignedMatrix<float>& B, const AlignedMatrix<float>& C);
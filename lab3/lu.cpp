@@ -0,0 +1,431 @@
+/* Реализация блочного LU-разложения и решения со смешанной точностью.
+    * factorPanel - рекурсивное разложение панели из nb столбцов (обновления - через gemm),
+      перестановки строк применяются к остальным столбцам после панели, по столбцам.
+    * luFactor - следующая панель раскладывается одним потоком одновременно с обновлением
+      остальных столбцов (вложенные команды OpenMP).
+    * solveUnitLower, solveUpper - подстановки в блоке, столбцы правой части делятся между потоками;
+      solveLowerBlocked, solveUpperBlocked - рекурсия до них с обновлениями через gemm.
+    * refine - уточнение решения невязками в double. */
+
+#include "lu.h"
+#include "gemm.h"
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    constexpr std::size_t panel_leaf = 16;  // Ширина панели, раскладываемой без рекурсии
+    constexpr std::size_t solve_leaf = 16;  // Строк в подстановке без рекурсии
+
+    // Перестановки строк j <-> pivots[j], j из [first, last), в столбцах [c0, c1)
+    template <class T>
+    void swapRows(std::size_t first, std::size_t last, const std::size_t* pivots, T* M, std::size_t ldm,
+                  std::size_t c0, std::size_t c1)
+    {
+#pragma omp parallel for if (c1 - c0 > 64)
+        for (std::size_t c = c0; c < c1; c++)
+        {
+            T* column = M + c * ldm;
+            for (std::size_t j = first; j < last; j++)
+            {
+                std::swap(column[j], column[pivots[j]]);
+            }
+        }
+    }
+
+    // X = L11^-1 * X: L11 - jb x jb с единичной диагональю, X - jb x cols
+    template <class T>
+    void solveUnitLower(std::size_t jb, std::size_t cols, const T* L, std::size_t ldl, T* X, std::size_t ldx)
+    {
+#pragma omp parallel for if (cols > 64)
+        for (std::size_t c = 0; c < cols; c++)
+        {
+            T* x = X + c * ldx;
+            for (std::size_t k = 0; k < jb; k++)
+            {
+                const T* column = L + k * ldl;
+                for (std::size_t i = k + 1; i < jb; i++)
+                {
+                    x[i] -= column[i] * x[k];
+                }
+            }
+        }
+    }
+
+    // X = U11^-1 * X: U11 - верхняя треугольная jb x jb, X - jb x cols
+    template <class T>
+    void solveUpper(std::size_t jb, std::size_t cols, const T* U, std::size_t ldu, T* X, std::size_t ldx)
+    {
+#pragma omp parallel for if (cols > 64)
+        for (std::size_t c = 0; c < cols; c++)
+        {
+            T* x = X + c * ldx;
+            for (std::size_t k = jb; k-- > 0;)
+            {
+                const T* column = U + k * ldu;
+                x[k] /= column[k];
+                for (std::size_t i = 0; i < k; i++)
+                {
+                    x[i] -= column[i] * x[k];
+                }
+            }
+        }
+    }
+
+    // Узкая панель без рекурсии: исключение по столбцам, перестановки строк только внутри панели
+    template <class T>
+    std::size_t factorLeaf(std::size_t n, std::size_t j0, std::size_t jb, T* M, std::size_t ldm,
+                           std::size_t* pivots)
+    {
+        for (std::size_t j = j0; j < j0 + jb; j++)
+        {
+            T* column = M + j * ldm;
+
+            // Ведущий элемент - наибольший по модулю в столбце
+            std::size_t p = j;
+            for (std::size_t i = j + 1; i < n; i++)
+            {
+                if (std::abs(column[i]) > std::abs(column[p]))
+                    p = i;
+            }
+            pivots[j] = p;
+            if (column[p] == 0)
+                return j + 1;
+            swapRows(j, j + 1, pivots, M, ldm, j0, j0 + jb);
+
+            const T inverse = 1 / column[j];
+            for (std::size_t i = j + 1; i < n; i++)
+            {
+                column[i] *= inverse;
+            }
+
+            // Исключение в оставшихся столбцах панели
+            for (std::size_t c = j + 1; c < j0 + jb; c++)
+            {
+                T* target = M + c * ldm;
+                const T factor = target[j];
+                for (std::size_t i = j + 1; i < n; i++)
+                {
+                    target[i] -= column[i] * factor;
+                }
+            }
+        }
+        return 0;
+    }
+
+    // Панель - столбцы [j0, j0 + jb) от строки j0 до n, рекурсивно пополам: левая половина,
+    // обновление правой (подстановка + gemm), правая половина. Перестановки - только внутри панели.
+    template <class T>
+    std::size_t factorPanel(std::size_t n, std::size_t j0, std::size_t jb, T* M, std::size_t ldm,
+                            std::size_t* pivots)
+    {
+        if (jb <= panel_leaf)
+            return factorLeaf(n, j0, jb, M, ldm, pivots);
+
+        const std::size_t h = jb / 2, j1 = j0 + h;
+        if (const std::size_t singular = factorPanel(n, j0, h, M, ldm, pivots))
+            return singular;
+
+        swapRows(j0, j1, pivots, M, ldm, j1, j0 + jb);
+        T* L11 = M + j0 * ldm + j0;
+        T* A12 = M + j1 * ldm + j0;
+        solveUnitLower(h, jb - h, L11, ldm, A12, ldm);
+        gemmParallel(n - j1, jb - h, h, T(-1), L11 + h, ldm, A12, ldm, T(1), A12 + h, ldm);
+
+        if (const std::size_t singular = factorPanel(n, j1, jb - h, M, ldm, pivots))
+            return singular;
+        swapRows(j1, j0 + jb, pivots, M, ldm, j0, j1);
+        return 0;
+    }
+
+    // X = L^-1 * X для L (n x n) с единичной диагональю, рекурсивно пополам:
+    // X1 = L11^-1 * X1, X2 -= L21 * X1 (gemm), X2 = L22^-1 * X2
+    template <class T>
+    void solveLowerBlocked(std::size_t n, std::size_t nrhs, const T* L, std::size_t ldl, T* X, std::size_t ldx)
+    {
+        if (n <= solve_leaf)
+        {
+            solveUnitLower(n, nrhs, L, ldl, X, ldx);
+            return;
+        }
+        const std::size_t h = n / 2;
+        solveLowerBlocked(h, nrhs, L, ldl, X, ldx);
+        gemmParallel(n - h, nrhs, h, T(-1), L + h, ldl, X, ldx, T(1), X + h, ldx);
+        solveLowerBlocked(n - h, nrhs, L + h * ldl + h, ldl, X + h, ldx);
+    }
+
+    // X = U^-1 * X для верхней треугольной U: сначала нижняя половина, затем X1 -= U12 * X2
+    template <class T>
+    void solveUpperBlocked(std::size_t n, std::size_t nrhs, const T* U, std::size_t ldu, T* X, std::size_t ldx)
+    {
+        if (n <= solve_leaf)
+        {
+            solveUpper(n, nrhs, U, ldu, X, ldx);
+            return;
+        }
+        const std::size_t h = n / 2;
+        solveUpperBlocked(n - h, nrhs, U + h * ldu + h, ldu, X + h, ldx);
+        gemmParallel(h, nrhs, n - h, T(-1), U + h * ldu, ldu, X + h, ldx, T(1), X, ldx);
+        solveUpperBlocked(h, nrhs, U, ldu, X, ldx);
+    }
+
+    double normInf(std::size_t n, const double* x)
+    {
+        double norm = 0;
+        for (std::size_t i = 0; i < n; i++)
+        {
+            norm = std::max(norm, std::abs(x[i]));
+        }
+        return norm;
+    }
+
+    // Норма матрицы по строкам: наибольшая сумма модулей строки
+    double normInf(std::size_t n, const double* M, std::size_t ldm)
+    {
+        std::vector<double> rowSums(n);
+        for (std::size_t j = 0; j < n; j++)
+        {
+            for (std::size_t i = 0; i < n; i++)
+            {
+                rowSums[i] += std::abs(M[j * ldm + i]);
+            }
+        }
+        return normInf(n, rowSums.data());
+    }
+
+    // r = b - M * x в double
+    void residual(std::size_t n, const double* M, std::size_t ldm, const double* b, const double* x, double* r)
+    {
+        std::copy(b, b + n, r);
+        for (std::size_t j = 0; j < n; j++)
+        {
+            const double* column = M + j * ldm;
+            for (std::size_t i = 0; i < n; i++)
+            {
+                r[i] -= column[i] * x[j];
+            }
+        }
+    }
+}
+
+template <class T>
+std::size_t luFactor(std::size_t n, T* M, std::size_t ldm, std::size_t* pivots, std::size_t nb, bool lookahead)
+{
+    if (n == 0)
+        return 0;
+    nb = std::max<std::size_t>(nb, 1);
+    const std::size_t threads = omp_get_max_threads();
+    lookahead = lookahead && threads > 1 && !omp_in_parallel();
+
+    // Каждая следующая панель раскладывается в конце предыдущего шага
+    std::size_t singular = factorPanel(n, 0, std::min(nb, n), M, ldm, pivots);
+    for (std::size_t j0 = 0; j0 < n && singular == 0; j0 += nb)
+    {
+        const std::size_t jb = std::min(nb, n - j0), j1 = j0 + jb;
+        swapRows(j0, j1, pivots, M, ldm, 0, j0); // Перестановки панели - в столбцах слева
+        swapRows(j0, j1, pivots, M, ldm, j1, n); // и справа от неё
+
+        const std::size_t rest = n - j1;
+        if (rest == 0)
+            break;
+
+        T* L11 = M + j0 * ldm + j0;
+        T* A12 = M + j1 * ldm + j0;
+        solveUnitLower(jb, rest, L11, ldm, A12, ldm);
+
+        // A22 -= L21 * U12: сначала столбцы следующей панели - от них зависит весь следующий шаг
+        const std::size_t next = std::min(nb, rest);
+        gemmParallel(rest, next, jb, T(-1), L11 + jb, ldm, A12, ldm, T(1), A12 + jb, ldm);
+
+        auto factorNext = [&] { singular = factorPanel(n, j1, next, M, ldm, pivots); };
+        auto updateRest = [&]
+        {
+            T* U12 = A12 + next * ldm;
+            gemmParallel(rest, rest - next, jb, T(-1), L11 + jb, ldm, U12, ldm, T(1), U12 + jb, ldm);
+        };
+        if (!lookahead || rest == next)
+        {
+            updateRest();
+            factorNext();
+            continue;
+        }
+
+        // Опережение: панель - один поток, остальные столбцы - остальная команда (столбцы не пересекаются)
+        const int levels = omp_get_max_active_levels();
+        omp_set_max_active_levels(std::max(levels, 2));
+#pragma omp parallel num_threads(2)
+        {
+            const int t = omp_get_thread_num(), team = omp_get_num_threads();
+            if (t == 0)
+            {
+                omp_set_num_threads(1);
+                factorNext();
+            }
+            if (t == team - 1) // При одном потоке в команде - оба шага по очереди
+            {
+                omp_set_num_threads(team == 1 ? threads : threads - 1);
+                updateRest();
+            }
+        }
+        omp_set_max_active_levels(levels);
+    }
+    return singular;
+}
+
+template <class T>
+void luSolve(std::size_t n, const T* LU, std::size_t ldlu, const std::size_t* pivots, T* b)
+{
+    for (std::size_t j = 0; j < n; j++) // Перестановки строк в порядке разложения
+    {
+        std::swap(b[j], b[pivots[j]]);
+    }
+
+    for (std::size_t k = 0; k < n; k++) // L * y = P * b, единичная диагональ
+    {
+        const T* column = LU + k * ldlu;
+        for (std::size_t i = k + 1; i < n; i++)
+        {
+            b[i] -= column[i] * b[k];
+        }
+    }
+
+    for (std::size_t k = n; k-- > 0;) // U * x = y, по столбцам снизу вверх
+    {
+        const T* column = LU + k * ldlu;
+        b[k] /= column[k];
+        for (std::size_t i = 0; i < k; i++)
+        {
+            b[i] -= column[i] * b[k];
+        }
+    }
+}
+
+template <class T>
+void luSolve(std::size_t n, std::size_t nrhs, const T* LU, std::size_t ldlu, const std::size_t* pivots, T* X,
+             std::size_t ldx)
+{
+    swapRows(0, n, pivots, X, ldx, 0, nrhs);
+    solveLowerBlocked(n, nrhs, LU, ldlu, X, ldx);
+    solveUpperBlocked(n, nrhs, LU, ldlu, X, ldx);
+}
+
+template <class T>
+void luInverse(std::size_t n, const T* LU, std::size_t ldlu, const std::size_t* pivots, T* Inv, std::size_t ldinv)
+{
+    for (std::size_t j = 0; j < n; j++)
+    {
+        std::fill(Inv + j * ldinv, Inv + j * ldinv + n, T(0));
+        Inv[j * ldinv + j] = 1;
+    }
+    luSolve(n, n, LU, ldlu, pivots, Inv, ldinv);
+}
+
+template <class T>
+lu_determinant luDeterminant(std::size_t n, const T* LU, std::size_t ldlu, const std::size_t* pivots)
+{
+    lu_determinant det{1, 0};
+    for (std::size_t j = 0; j < n; j++)
+    {
+        const double u = LU[j * ldlu + j];
+        if (u == 0)
+            return lu_determinant{0, -std::numeric_limits<double>::infinity()};
+        if ((u < 0) != (pivots[j] != j)) // Отрицательный элемент или перестановка меняют знак
+            det.sign = -det.sign;
+        det.log_abs += std::log(std::abs(u));
+    }
+    return det;
+}
+
+template std::size_t luFactor<double>(std::size_t, double*, std::size_t, std::size_t*, std::size_t, bool);
+template std::size_t luFactor<float>(std::size_t, float*, std::size_t, std::size_t*, std::size_t, bool);
+template void luSolve<double>(std::size_t, const double*, std::size_t, const std::size_t*, double*);
+template void luSolve<float>(std::size_t, const float*, std::size_t, const std::size_t*, float*);
+template void luSolve<double>(std::size_t, std::size_t, const double*, std::size_t, const std::size_t*, double*,
+                              std::size_t);
+template void luSolve<float>(std::size_t, std::size_t, const float*, std::size_t, const std::size_t*, float*,
+                             std::size_t);
+template void luInverse<double>(std::size_t, const double*, std::size_t, const std::size_t*, double*, std::size_t);
+template void luInverse<float>(std::size_t, const float*, std::size_t, const std::size_t*, float*, std::size_t);
+template lu_determinant luDeterminant<double>(std::size_t, const double*, std::size_t, const std::size_t*);
+template lu_determinant luDeterminant<float>(std::size_t, const float*, std::size_t, const std::size_t*);
+
+refine_result solveDouble(std::size_t n, const double* M, std::size_t ldm, const double* b, double* x)
+{
+    std::vector<double> LU(n * n);
+    for (std::size_t j = 0; j < n; j++)
+    {
+        std::copy(M + j * ldm, M + j * ldm + n, LU.data() + j * n);
+    }
+    std::vector<std::size_t> pivots(n);
+
+    refine_result result;
+    std::copy(b, b + n, x);
+    if (luFactor(n, LU.data(), n, pivots.data()) == 0)
+        luSolve(n, LU.data(), n, pivots.data(), x);
+
+    std::vector<double> r(n);
+    residual(n, M, ldm, b, x, r.data());
+    result.residual = normInf(n, r.data()) / (normInf(n, M, ldm) * normInf(n, x));
+    return result;
+}
+
+refine_result solveMixed(std::size_t n, const double* M, std::size_t ldm, const double* b, double* x,
+                         std::size_t max_iterations)
+{
+    std::vector<float> LU(n * n);
+    for (std::size_t j = 0; j < n; j++)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            LU[j * n + i] = static_cast<float>(M[j * ldm + i]);
+        }
+    }
+    std::vector<std::size_t> pivots(n);
+    if (luFactor(n, LU.data(), n, pivots.data()) != 0)
+        return solveDouble(n, M, ldm, b, x);
+
+    const double normM = normInf(n, M, ldm);
+    const double tolerance = std::numeric_limits<double>::epsilon() * std::sqrt(static_cast<double>(n));
+    std::vector<double> r(n);
+    std::vector<float> d(n);
+
+    // Начальное решение и каждая поправка - по float-разложению
+    auto correction = [&](const double* rhs)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            d[i] = static_cast<float>(rhs[i]);
+        }
+        luSolve(n, LU.data(), n, pivots.data(), d.data());
+    };
+
+    correction(b);
+    std::copy(d.begin(), d.end(), x);
+
+    refine_result result;
+    for (;;)
+    {
+        residual(n, M, ldm, b, x, r.data());
+        const double normX = normInf(n, x);
+        const double normR = normInf(n, r.data());
+        result.residual = normR / (normM * normX);
+        if (normR <= normX * normM * tolerance)
+        {
+            result.converged = true;
+            return result;
+        }
+        if (result.iterations == max_iterations)
+            break;
+
+        correction(r.data());
+        for (std::size_t i = 0; i < n; i++)
+        {
+            x[i] += d[i];
+        }
+        result.iterations++;
+    }
+
+    return solveDouble(n, M, ldm, b, x); // Уточнение не сошлось (плохая обусловленность для float)
+}
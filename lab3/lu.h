@@ -0,0 +1,73 @@
+/* LU-разложение и решение систем - основные моменты:
+    Матрицы по столбцам, как в gemm.h; T - double или float.
+
+    Разложение luFactor (P * M = L * U, частичный выбор ведущего элемента):
+        * блоками по nb столбцов: панель раскладывается построчными исключениями с выбором
+          наибольшего по модулю элемента столбца, строки переставляются целиком;
+        * U12 = L11^-1 * A12 - прямая подстановка с единичной диагональю;
+        * A22 -= L21 * U12 - gemmParallel: почти вся работа O(n^3) - в блочном умножении;
+        * опережение (lookahead): сначала обновляются столбцы следующей панели, затем она раскладывается
+          одним потоком, пока остальные потоки обновляют прочие столбцы A22 - между панелями
+          команда не простаивает.
+      L (без единичной диагонали) и U хранятся на месте M, pivots[j] - строка, переставленная с j.
+
+    По готовому разложению:
+        * luSolve для nrhs правых частей - треугольные подстановки рекурсивно пополам: половина
+          решается, вклад в другую половину вычитается gemmParallel с общей размерностью n/2, n/4, ...,
+          до блоков в 16 строк - подстановкой;
+        * luInverse - решение для единичной правой части, 2n^3 операций почти целиком в gemm;
+        * luDeterminant - знак и логарифм модуля: для n в тысячи произведение диагонали U
+          выходит за пределы double.
+
+    Смешанная точность (solveMixed):
+        * M округляется до float и раскладывается sgemm-путём - O(n^3) операций в одинарной точности;
+        * невязка r = b - M * x считается в double, поправка d - решение по float-разложению, x += d;
+        * итерации до ||r|| <= ||x|| * ||M|| * eps(double) * sqrt(n) (как в LAPACK dsgesv);
+          если за max_iterations не сошлось или матрица вырождена во float - решение в double. */
+
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Разложение матрицы n x n на месте; 0 - успех, иначе номер (с 1) нулевого ведущего элемента
+template <class T>
+std::size_t luFactor(std::size_t n, T* M, std::size_t ldm, std::size_t* pivots, std::size_t nb = 32,
+                     bool lookahead = true);
+
+// Решение LU * x = P * b по готовому разложению, b заменяется на x
+template <class T>
+void luSolve(std::size_t n, const T* LU, std::size_t ldlu, const std::size_t* pivots, T* b);
+
+// То же для nrhs правых частей - столбцов X (n x nrhs)
+template <class T>
+void luSolve(std::size_t n, std::size_t nrhs, const T* LU, std::size_t ldlu, const std::size_t* pivots, T* X,
+             std::size_t ldx);
+
+// Обратная матрица по разложению
+template <class T>
+void luInverse(std::size_t n, const T* LU, std::size_t ldlu, const std::size_t* pivots, T* Inv, std::size_t ldinv);
+
+// Определитель det = sign * exp(log_abs); у вырожденной sign = 0
+struct lu_determinant
+{
+    int sign;
+    double log_abs;
+};
+
+template <class T>
+lu_determinant luDeterminant(std::size_t n, const T* LU, std::size_t ldlu, const std::size_t* pivots);
+
+// Итог решения со смешанной точностью
+struct refine_result
+{
+    std::size_t iterations = 0; // Шагов уточнения
+    bool converged = false;     // false - решено в double после неудачи во float
+    double residual = 0;        // ||b - M * x||_inf / (||M||_inf * ||x||_inf)
+};
+
+// M * x = b: разложение во float, уточнение невязки в double
+refine_result solveMixed(std::size_t n, const double* M, std::size_t ldm, const double* b, double* x,
+                         std::size_t max_iterations = 30);
+
+// M * x = b полностью в double
+refine_result solveDouble(std::size_t n, const double* M, std::size_t ldm, const double* b, double* x);
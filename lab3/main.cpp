@@ -2,6 +2,43 @@
     Матричное умножение:
         * Скалярное умножение (mulMatrix) использует тройной вложенный цикл.
         * Векторизованное умножение (mulMatrix256) использует AVX-инструкции для ускорения вычислений.
+        * Блочное умножение с упаковкой панелей (mulMatrixPacked, gemm.h) - схема GotoBLAS
+          с микроядром на FMA, тайл результата целиком в регистрах.
+        * Режим parallel (./lab3 parallel [--n=N]) - многопоточное умножение gemmParallel матриц N x N
+          (по умолчанию 2048) для каждого количества потоков, время - в output_parallel.csv (T,Duration).
+        * Режим strassen (./lab3 strassen [--n=N] [--cutoff=C]) - умножение Штрассена - Винограда
+          (strassen.h) с порогами от N до C (по умолчанию 128), время и относительная погрешность
+          относительно mulMatrix - в output_strassen.csv (cutoff,Duration,Error).
+        * Умножение с учётом структуры (multiply, structured.h) - операнды классифицируются
+          (единичная, диагональная, перестановочная, разреженная), для единичной B и перестановочной C
+          из основного теста это копирование столбцов за O(n^2) вместо O(n^3).
+        * Режим small (./lab3 small [--count=N]) - пакетное умножение N (по умолчанию 20000) квадратных
+          матриц n x n, n = 3..32: ядра smallGemm<n, n, n> (small_gemm.h) против gemm для каждой матрицы,
+          время - в output_small.csv (n,batched,gemm). Там же проверяются mulMatrix256 и mulMatrixPacked
+          на матрицах произвольного размера (хвост столбца - загрузка по маске).
+        * Режим refine (./lab3 refine [--n=N]) - умножение в double и float (gemmParallel) и решение
+          системы N x N (по умолчанию 2048): LU в double против LU во float с уточнением невязки в double
+          (lu.h), время и невязка - в output_refine.csv (method,Duration,Residual,Iterations).
+        * Режим lu (./lab3 lu [--n=N] [--nb=NB]) - блочное LU-разложение матрицы N x N (по умолчанию 2048)
+          панелями по NB столбцов (по умолчанию 32) без опережения и с опережением, решение для одной
+          и для N правых частей, обратная матрица и определитель (lu.h); время и GFLOPS - в output_lu.csv
+          (method,Duration,GFLOPS), проверка - ||M * M^-1 - I||.
+        * Режим transpose (./lab3 transpose [--n=N]) - транспонирование матрицы N x N (по умолчанию 2048)
+          простым циклом, рекурсивное с тайлами в регистрах (transpose.h) и на месте, а также умножение
+          матриц по строкам: транспонирование + gemmParallel против gemmParallel с matrix_layout::row_major.
+          Время - в output_transpose.csv (method,Duration).
+        * Режим chain (./lab3 chain [--count=N] [--n=N]) - произведение цепочки из N (по умолчанию 10) матриц
+          случайных размеров от 8 до N (по умолчанию 512): слева направо mulMatrix256 и gemmParallel против
+          порядка скобок из динамического программирования с параллельными независимыми произведениями
+          и пулом буферов (chain.h). Время и число операций - в output_chain.csv (method,Duration,GFLOP).
+        * Режим cblas (./lab3 cblas [--n=N]) - cblas_dgemm (cblas.h, та же функция собирается в liblab3blas.so)
+          против mulMatrix256 на матрицах N x N (по умолчанию 2048): по столбцам, по строкам
+          и с транспонированием обоих операндов, C = 1.5 * op(A) * op(B) + 0.5 * C; время - в output_cblas.csv
+          (method,Duration).
+        * Режим autotune (./lab3 autotune [--n=N]) - подбор формы микроядра, размеров блоков и раскладки
+          потоков gemm на матрицах N x N (по умолчанию 1024, autotune.h), все замеры - в output_autotune.csv
+          (mr,nr,mc,kc,nc,grid,GFLOPS), лучшая настройка - в профиль ../gemm_profile_<хост>.txt.
+          Все режимы при запуске загружают профиль этой машины, если он есть.
 
     Генерация матриц:
         * getIdentityMatrix создает единичную матрицу.
@@ -12,16 +49,38 @@
 
     Сравнение результатов:
         * Результаты скалярного и векторного умножения сравниваются с помощью memcmp.
+
+    Хранение матриц:
+        * Матрицы лежат в AlignedMatrix (common/aligned_matrix.h) по столбцам: "строка" контейнера -
+          столбец матрицы, длина столбца дополнена до 64 байт и не кратна 4 КиБ (ведущая размерность
+          stride вместо rB), память на больших страницах.
+        * Перегрузки mulMatrix и mulMatrix256 для AlignedMatrix используют stride и выровненные загрузки.
 */
 
 #include <assert.h>
 #include <immintrin.h>
 #include <algorithm>
+#include <charconv>
+#include <stdexcept>
 #include <chrono>
 #include <iostream>
 #include <vector>
 #include <cstring>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <omp.h>
 #include "fstream"
+#include "../common/aligned_matrix.h"
+#include "gemm.h"
+#include "strassen.h"
+#include "structured.h"
+#include "small_gemm.h"
+#include "lu.h"
+#include "transpose.h"
+#include "autotune.h"
+#include "chain.h"
+#include "cblas.h"
 using namespace std;
 
 const size_t matrixSize = 64 * (1 << 4); // Размер матрицы: 64 * 16 = 1024
@@ -41,7 +100,6 @@ void mulMatrix(
         )
 {
     assert(cB == rC && cA == cC && rA == rB);
-    assert((cA & 0x3f) == 0); // Проверка, что размер кратен 64
 
     for (size_t i = 0; i < cA; i++)
     {
@@ -56,6 +114,12 @@ void mulMatrix(
     }
 }
 
+// Маска первых count элементов регистра AVX (count < 4) для хвоста столбца
+__m256i tailMask(size_t count)
+{
+    return _mm256_cmpgt_epi64(_mm256_set1_epi64x(count), _mm256_set_epi64x(3, 2, 1, 0));
+}
+
 // Функция для матричного умножения с использованием AVX (векторизация)
 void mulMatrix256(
         double* A, // Результирующая матрица
@@ -70,7 +134,6 @@ void mulMatrix256(
         )
 {
     assert(cB == rC && cA == cC && rA == rB);
-    assert((cA & 0x3f) == 0); // Проверка, что размер кратен 64
 
     const size_t values_per_operation = 4; // Количество double, обрабатываемых за одну операцию AVX
 
@@ -89,6 +152,82 @@ void mulMatrix256(
             _mm256_storeu_pd(A + j * rA + i * values_per_operation, sum); // Сохранение результата в A
         }
     }
+    // Хвост столбца (rB не кратно 4) - загрузка и сохранение по маске
+    const size_t tail = rB % values_per_operation;
+    if (tail != 0)
+    {
+        const __m256i mask = tailMask(tail);
+        const size_t i = rB - tail;
+        for (size_t j = 0; j < cC; j++)
+        {
+            __m256d sum = _mm256_setzero_pd();
+            for (size_t k = 0; k < rC; k++)
+            {
+                __m256d bCol = _mm256_maskload_pd(B + rB * k + i, mask);
+                sum = _mm256_fmadd_pd(bCol, _mm256_set1_pd(C[j * rC + k]), sum);
+            }
+            _mm256_maskstore_pd(A + j * rA + i, mask, sum);
+        }
+    }
+}
+
+// Скалярное умножение выровненных матриц A = B * C (столбцы хранятся с шагом stride)
+void mulMatrix(AlignedMatrix<double>& A, const AlignedMatrix<double>& B, const AlignedMatrix<double>& C)
+{
+    // Для контейнера по столбцам: cols() - количество строк матрицы, rows() - количество столбцов
+    assert(B.rows() == C.cols() && A.rows() == C.rows() && A.cols() == B.cols());
+
+    for (size_t i = 0; i < A.rows(); i++)
+    {
+        for (size_t j = 0; j < A.cols(); j++)
+        {
+            A(i, j) = 0; // Инициализация элемента A[i][j]
+            for (size_t k = 0; k < B.rows(); k++)
+            {
+                A(i, j) += B(k, j) * C(i, k); // Умножение и сложение
+            }
+        }
+    }
+}
+
+// Векторизованное умножение выровненных матриц: столбцы начинаются на границе 64 байт
+void mulMatrix256(AlignedMatrix<double>& A, const AlignedMatrix<double>& B, const AlignedMatrix<double>& C)
+{
+    assert(B.rows() == C.cols() && A.rows() == C.rows() && A.cols() == B.cols());
+
+    const size_t values_per_operation = 4; // Количество double, обрабатываемых за одну операцию AVX
+
+    for (size_t i = 0; i < B.cols() / values_per_operation; i++)
+    {
+        for (size_t j = 0; j < C.rows(); j++)
+        {
+            __m256d sum = _mm256_setzero_pd(); // Инициализация суммы нулями
+            for (size_t k = 0; k < C.cols(); k++)
+            {
+                __m256d bCol = _mm256_load_pd(B.row(k) + i * values_per_operation); // Выровненная загрузка из B
+                __m256d broadcasted = _mm256_set1_pd(C(j, k)); // Броадкастинг элемента из C
+                sum = _mm256_fmadd_pd(bCol, broadcasted, sum); // Умножение и сложение
+            }
+
+            _mm256_store_pd(A.row(j) + i * values_per_operation, sum); // Выровненное сохранение в A
+        }
+    }
+    // Хвост столбца - по маске, чтобы не писать в дополнение до 64 байт
+    const size_t tail = B.cols() % values_per_operation;
+    if (tail != 0)
+    {
+        const __m256i mask = tailMask(tail);
+        const size_t i = B.cols() - tail;
+        for (size_t j = 0; j < C.rows(); j++)
+        {
+            __m256d sum = _mm256_setzero_pd();
+            for (size_t k = 0; k < C.cols(); k++)
+            {
+                sum = _mm256_fmadd_pd(_mm256_maskload_pd(B.row(k) + i, mask), _mm256_set1_pd(C(j, k)), sum);
+            }
+            _mm256_maskstore_pd(A.row(j) + i, mask, sum);
+        }
+    }
 }
 
 // Функция для создания случайной перестановочной матрицы
@@ -127,11 +266,738 @@ vector<double> getIdentityMatrix(size_t n)
     return matrix;
 }
 
+// Режим "parallel": многопоточное умножение матриц n x n с разным количеством потоков,
+// результаты записываются в output_parallel.csv
+int parallelMain(size_t n)
+{
+    std::ofstream output("../output_parallel.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    AlignedMatrix<double> A(n, n), B(n, n), C(n, n), R(n, n);
+    for (size_t j = 0; j < n; j++)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            B(j, i) = rand() % 19 - 9; // Небольшие целые - результат считается точно
+            C(j, i) = rand() % 19 - 9;
+        }
+    }
+    mulMatrixPacked(R, B, C); // Однопоточный результат для проверки
+
+    const size_t threadCount = std::thread::hardware_concurrency();
+    const double flops = 2.0 * n * n * n;
+
+    cout << "T\t| Duration, ms\t| GFLOPS\n";
+    output << "T,Duration\n";
+
+    for (size_t T = 1; T <= threadCount; T++)
+    {
+        omp_set_num_threads(T);
+
+        double total_time = 0;
+        for (int test = 0; test < num_tests; ++test)
+        {
+            auto t1 = chrono::steady_clock::now();
+            mulMatrixParallel(A, B, C);
+            auto t2 = chrono::steady_clock::now();
+            total_time += chrono::duration_cast<chrono::milliseconds>(t2 - t1).count();
+        }
+
+        if (!(A == R))
+        {
+            cout << "Wrong result for T = " << T << "\n";
+            return -1;
+        }
+
+        double avg_time = total_time / num_tests;
+        cout << T << "\t| " << avg_time << "\t\t| " << flops / avg_time / 1e6 << "\n";
+        output << T << "," << avg_time << "\n";
+    }
+
+    output.close();
+    return 0;
+}
+
+// Режим "strassen": умножение Штрассена - Винограда с разными порогами рекурсии,
+// время и погрешность относительно mulMatrix записываются в output_strassen.csv
+int strassenMain(size_t n, size_t minCutoff)
+{
+    std::ofstream output("../output_strassen.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    AlignedMatrix<double> A(n, n), B(n, n), C(n, n), R(n, n);
+    for (size_t j = 0; j < n; j++)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            B(j, i) = 2.0 * rand() / RAND_MAX - 1; // Случайные числа из [-1, 1]
+            C(j, i) = 2.0 * rand() / RAND_MAX - 1;
+        }
+    }
+    mulMatrix(R, B, C); // Эталон - скалярное умножение
+
+    // Наибольшее отклонение от эталона относительно наибольшего элемента эталона
+    auto relativeError = [&]
+    {
+        double error = 0, scale = 0;
+        for (size_t j = 0; j < n; j++)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                error = max(error, abs(A(j, i) - R(j, i)));
+                scale = max(scale, abs(R(j, i)));
+            }
+        }
+        return error / scale;
+    };
+
+    vector<double> workspace;
+    cout << "Cutoff\t| Duration, ms\t| Error\n";
+    output << "cutoff,Duration,Error\n";
+
+    // Порог n - без рекурсии (только gemmParallel), каждый следующий - ещё один уровень
+    for (size_t cutoff = n; cutoff >= max<size_t>(minCutoff, 1); cutoff /= 2)
+    {
+        double total_time = 0;
+        for (int test = 0; test < num_tests; ++test)
+        {
+            auto t1 = chrono::steady_clock::now();
+            mulMatrixStrassen(A, B, C, cutoff, workspace);
+            auto t2 = chrono::steady_clock::now();
+            total_time += chrono::duration_cast<chrono::milliseconds>(t2 - t1).count();
+        }
+
+        double avg_time = total_time / num_tests;
+        double error = relativeError();
+        cout << cutoff << "\t| " << avg_time << "\t\t| " << error << "\n";
+        output << cutoff << "," << avg_time << "," << error << "\n";
+    }
+
+    output.close();
+    return 0;
+}
+
+// Режим "small": пакетное умножение малых матриц, время записывается в output_small.csv
+int smallMain(size_t count)
+{
+    std::ofstream output("../output_small.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    cout << "n\t| Batched, ms\t| gemm, ms\n";
+    output << "n,batched,gemm\n";
+
+    for (size_t n = 3; n <= small_gemm_max; n++)
+    {
+        const size_t size = n * n;
+        vector<double> A(count * size), R(count * size), B(count * size), C(count * size);
+        for (size_t i = 0; i < count * size; i++)
+        {
+            B[i] = rand() % 19 - 9;
+            C[i] = rand() % 19 - 9;
+        }
+
+        double batched_time = 0, gemm_time = 0;
+        for (int test = 0; test < num_tests; ++test)
+        {
+            auto t1 = chrono::steady_clock::now();
+            smallGemmBatch(n, count, A.data(), B.data(), C.data());
+            auto t2 = chrono::steady_clock::now();
+            batched_time += chrono::duration_cast<chrono::microseconds>(t2 - t1).count() / 1000.0;
+
+            t1 = chrono::steady_clock::now();
+            for (size_t b = 0; b < count; b++)
+            {
+                gemm(n, n, n, 1, B.data() + b * size, n, C.data() + b * size, n, 0, R.data() + b * size, n);
+            }
+            t2 = chrono::steady_clock::now();
+            gemm_time += chrono::duration_cast<chrono::microseconds>(t2 - t1).count() / 1000.0;
+        }
+
+        // Полные ядра на матрицах того же размера: длина столбца не кратна 4 и 64
+        AlignedMatrix<double> D(n, n), E(n, n), F(n, n), G(n, n), H(n, n);
+        G.assign(B.data());
+        H.assign(C.data());
+        mulMatrix(D, G, H);
+        mulMatrix256(E, G, H);
+        mulMatrixPacked(F, G, H);
+
+        if (A != R || !(D == E && D == F))
+        {
+            cout << "Wrong result for n = " << n << "\n";
+            return -1;
+        }
+
+        cout << n << "\t| " << batched_time / num_tests << "\t\t| " << gemm_time / num_tests << "\n";
+        output << n << "," << batched_time / num_tests << "," << gemm_time / num_tests << "\n";
+    }
+
+    output.close();
+    return 0;
+}
+
+// Режим "refine": умножение и решение системы в двойной и смешанной точности,
+// результаты записываются в output_refine.csv
+int refineMain(size_t n)
+{
+    std::ofstream output("../output_refine.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    AlignedMatrix<double> A(n, n), B(n, n), C(n, n);
+    AlignedMatrix<float> Af(n, n), Bf(n, n), Cf(n, n);
+    vector<double> b(n), x(n);
+    for (size_t j = 0; j < n; j++)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            B(j, i) = 2.0 * rand() / RAND_MAX - 1; // Случайные числа из [-1, 1]
+            C(j, i) = 2.0 * rand() / RAND_MAX - 1;
+            Bf(j, i) = static_cast<float>(B(j, i));
+            Cf(j, i) = static_cast<float>(C(j, i));
+        }
+        b[j] = 2.0 * rand() / RAND_MAX - 1;
+    }
+
+    // Среднее время функции в мс
+    auto measure = [](auto&& run)
+    {
+        double total_time = 0;
+        for (int test = 0; test < num_tests; ++test)
+        {
+            auto t1 = chrono::steady_clock::now();
+            run();
+            auto t2 = chrono::steady_clock::now();
+            total_time += chrono::duration_cast<chrono::milliseconds>(t2 - t1).count();
+        }
+        return total_time / num_tests;
+    };
+
+    cout << "Method\t\t| Duration, ms\t| Residual\t| Iterations\n";
+    output << "method,Duration,Residual,Iterations\n";
+    auto report = [&](const string& method, double time, double residual, size_t iterations)
+    {
+        cout << method << "\t\t| " << time << "\t\t| " << residual << "\t| " << iterations << "\n";
+        output << method << "," << time << "," << residual << "," << iterations << "\n";
+    };
+
+    // Умножение: для float - наибольшее отклонение от результата в double
+    const double dgemm_time = measure([&] { mulMatrixParallel(A, B, C); });
+    report("dgemm", dgemm_time, 0, 0);
+    const double sgemm_time = measure([&] { mulMatrixParallel(Af, Bf, Cf); });
+    double sgemm_error = 0;
+    for (size_t j = 0; j < n; j++)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            sgemm_error = max(sgemm_error, abs(Af(j, i) - A(j, i)));
+        }
+    }
+    report("sgemm", sgemm_time, sgemm_error, 0);
+
+    // Решение системы B * x = b: невязка ||b - B * x|| / (||B|| * ||x||)
+    refine_result result;
+    const double lu_time = measure([&] { result = solveDouble(n, B.data(), B.stride(), b.data(), x.data()); });
+    report("lu_double", lu_time, result.residual, result.iterations);
+    const double mixed_time = measure([&] { result = solveMixed(n, B.data(), B.stride(), b.data(), x.data()); });
+    report(result.converged ? "lu_mixed" : "lu_fallback", mixed_time, result.residual, result.iterations);
+
+    output.close();
+    return 0;
+}
+
+// Режим "lu": разложение, решение, обратная матрица и определитель, время - в output_lu.csv
+int luMain(size_t n, size_t nb)
+{
+    std::ofstream output("../output_lu.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    AlignedMatrix<double> M(n, n), LU(n, n), X(n, n), Inv(n, n), R(n, n);
+    for (size_t j = 0; j < n; j++)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            M(j, i) = 2.0 * rand() / RAND_MAX - 1; // Случайные числа из [-1, 1]
+        }
+    }
+    vector<size_t> pivots(n);
+
+    // Среднее время функции в мс; prepare перед каждым запуском не входит во время
+    auto measure = [](auto&& prepare, auto&& run)
+    {
+        double total_time = 0;
+        for (int test = 0; test < num_tests; ++test)
+        {
+            prepare();
+            auto t1 = chrono::steady_clock::now();
+            run();
+            auto t2 = chrono::steady_clock::now();
+            total_time += chrono::duration_cast<chrono::microseconds>(t2 - t1).count() / 1000.0;
+        }
+        return total_time / num_tests;
+    };
+
+    cout << "Method\t\t| Duration, ms\t| GFLOPS\n";
+    output << "method,Duration,GFLOPS\n";
+    auto report = [&](const string& method, double time, double flops)
+    {
+        cout << method << "\t\t| " << time << "\t\t| " << flops / time / 1e6 << "\n";
+        output << method << "," << time << "," << flops / time / 1e6 << "\n";
+    };
+
+    // Одинаковый размер - одинаковый шаг столбцов, копируется весь буфер
+    auto copyM = [&] { std::memcpy(LU.data(), M.data(), n * M.stride() * sizeof(double)); };
+    auto copyRhs = [&] { std::memcpy(X.data(), M.data(), n * M.stride() * sizeof(double)); };
+    const double nd = static_cast<double>(n);
+    size_t singular = 0;
+    for (bool lookahead : {false, true})
+    {
+        const double time = measure(copyM, [&]
+        {
+            singular = luFactor(n, LU.data(), LU.stride(), pivots.data(), nb, lookahead);
+        });
+        report(lookahead ? "lookahead" : "factor", time, 2 * nd * nd * nd / 3);
+    }
+    if (singular)
+    {
+        cout << "Singular matrix\n";
+        return -1;
+    }
+
+    report("solve_1", measure(copyRhs, [&] { luSolve(n, LU.data(), LU.stride(), pivots.data(), X.data()); }),
+           2 * nd * nd);
+    report("solve_n", measure(copyRhs, [&]
+    {
+        luSolve(n, n, LU.data(), LU.stride(), pivots.data(), X.data(), X.stride());
+    }), 2 * nd * nd * nd);
+    report("inverse", measure([] {}, [&]
+    {
+        luInverse(n, LU.data(), LU.stride(), pivots.data(), Inv.data(), Inv.stride());
+    }), 2 * nd * nd * nd);
+
+    // Проверка: ||M * M^-1 - I|| по наибольшему элементу
+    mulMatrixParallel(R, M, Inv);
+    double error = 0;
+    for (size_t j = 0; j < n; j++)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            error = max(error, abs(R(j, i) - (i == j ? 1.0 : 0.0)));
+        }
+    }
+    const lu_determinant det = luDeterminant(n, LU.data(), LU.stride(), pivots.data());
+    cout << "||M * M^-1 - I|| = " << error << "\n";
+    cout << "det(M) = " << det.sign << " * exp(" << det.log_abs << ")\n";
+
+    output.close();
+    return 0;
+}
+
+// Режим "transpose": транспонирование и умножение матриц, лежащих по строкам,
+// результаты записываются в output_transpose.csv
+int transposeMain(size_t n)
+{
+    std::ofstream output("../output_transpose.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    // Матрицы по строкам, как их готовят вызывающие программы
+    vector<double> B(n * n), C(n * n), Bt(n * n), Ct(n * n), A(n * n), R(n * n);
+    for (size_t i = 0; i < n * n; i++)
+    {
+        B[i] = rand() % 19 - 9;
+        C[i] = rand() % 19 - 9;
+    }
+
+    auto measure = [](auto&& run)
+    {
+        double total_time = 0;
+        for (int test = 0; test < num_tests; ++test)
+        {
+            auto t1 = chrono::steady_clock::now();
+            run();
+            auto t2 = chrono::steady_clock::now();
+            total_time += chrono::duration_cast<chrono::microseconds>(t2 - t1).count() / 1000.0;
+        }
+        return total_time / num_tests;
+    };
+
+    cout << "Method\t\t| Duration, ms\n";
+    output << "method,Duration\n";
+    auto report = [&](const string& method, double time)
+    {
+        cout << method << "\t\t| " << time << "\n";
+        output << method << "," << time << "\n";
+    };
+
+    // Транспонирование: простой цикл, рекурсивное, на месте (дважды - возврат к исходной)
+    report("naive", measure([&]
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            for (size_t j = 0; j < n; j++)
+            {
+                Bt[j * n + i] = B[i * n + j];
+            }
+        }
+    }));
+    report("recursive", measure([&] { transpose(n, n, B.data(), n, Ct.data(), n); }));
+    if (Bt != Ct)
+    {
+        cout << "Wrong transpose\n";
+        return -1;
+    }
+    report("in_place", measure([&] { transposeInPlace(n, Ct.data(), n); }));
+
+    // Умножение по строкам: перевод в столбцы и обратно или флаг расположения
+    report("transpose_gemm", measure([&]
+    {
+        transpose(n, n, B.data(), n, Bt.data(), n);
+        transpose(n, n, C.data(), n, Ct.data(), n);
+        gemmParallel(n, n, n, 1, Bt.data(), n, Ct.data(), n, 0, R.data(), n);
+        transposeInPlace(n, R.data(), n);
+    }));
+    report("row_major_gemm", measure([&]
+    {
+        gemmParallel(matrix_layout::row_major, matrix_op::none, matrix_op::none, n, n, n, 1, B.data(), n, C.data(), n,
+                     0, A.data(), n);
+    }));
+    if (A != R)
+    {
+        cout << "Wrong row-major result\n";
+        return -1;
+    }
+
+    output.close();
+    return 0;
+}
+
+// Режим "autotune": подбор настройки gemm, замеры - в output_autotune.csv, лучшая - в профиль машины
+int autotuneMain(size_t n)
+{
+    std::ofstream output("../output_autotune.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    const gemm_config before = gemmConfig();
+    const autotune_result result = autotuneGemm(n);
+
+    cout << "mr x nr\t| mc\t| kc\t| nc\t| grid\t| GFLOPS\n";
+    output << "mr,nr,mc,kc,nc,grid,GFLOPS\n";
+    for (const autotune_trial& trial : result.trials)
+    {
+        const gemm_config& c = trial.config;
+        cout << c.kernel.mr << " x " << c.kernel.nr << "\t| " << c.blocking.mc << "\t| " << c.blocking.kc << "\t| "
+             << c.blocking.nc << "\t| " << gridName(c.grid) << "\t| " << trial.gflops << "\n";
+        output << c.kernel.mr << "," << c.kernel.nr << "," << c.blocking.mc << "," << c.blocking.kc << ","
+               << c.blocking.nc << "," << gridName(c.grid) << "," << trial.gflops << "\n";
+    }
+
+    const gemm_config& best = result.best;
+    cout << "Best: " << best.kernel.mr << " x " << best.kernel.nr << ", mc = " << best.blocking.mc
+         << ", kc = " << best.blocking.kc << ", nc = " << best.blocking.nc << ", grid = " << gridName(best.grid)
+         << ", " << result.gflops << " GFLOPS (was " << before.kernel.mr << " x " << before.kernel.nr
+         << ", mc = " << before.blocking.mc << ", kc = " << before.blocking.kc << ", nc = " << before.blocking.nc
+         << ")\n";
+
+    const string path = gemmProfilePath();
+    if (!saveGemmProfile(path, best))
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+    cout << "Profile saved to " << path << "\n";
+
+    output.close();
+    return 0;
+}
+
+// Режим "chain": цепочка матриц слева направо и в оптимальном порядке, время - в output_chain.csv
+int chainMain(size_t count, size_t n)
+{
+    if (count == 0)
+    {
+        std::cout << "Chain must contain at least one matrix\n";
+        return -1;
+    }
+
+    std::ofstream output("../output_chain.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    // Mi - dims[i] x dims[i + 1], плотные по столбцам
+    vector<size_t> dims(count + 1);
+    for (size_t& d : dims)
+    {
+        d = 8 + rand() % (std::max<size_t>(n, 8) - 7);
+    }
+    vector<vector<double>> M(count);
+    vector<chain_matrix> operands(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        M[i].resize(dims[i] * dims[i + 1]);
+        for (double& x : M[i])
+        {
+            x = (rand() % 19 - 9) / 9.0 / sqrt(dims[i]); // Нормы произведений остаются порядка единицы
+        }
+        operands[i] = chain_matrix{M[i].data(), dims[i], dims[i + 1], dims[i]};
+    }
+
+    const chain_plan plan = planChain(dims);
+    cout << "Chain: " << chainOrder(plan) << "\n";
+
+    auto measure = [](auto&& run)
+    {
+        double total_time = 0;
+        for (int test = 0; test < num_tests; ++test)
+        {
+            auto t1 = chrono::steady_clock::now();
+            run();
+            auto t2 = chrono::steady_clock::now();
+            total_time += chrono::duration_cast<chrono::microseconds>(t2 - t1).count() / 1000.0;
+        }
+        return total_time / num_tests;
+    };
+
+    cout << "Method\t\t\t| Duration, ms\t| GFLOP\n";
+    output << "method,Duration,GFLOP\n";
+    auto report = [&](const string& method, double time, double flops)
+    {
+        cout << method << (method.size() < 16 ? "\t\t\t| " : "\t| ") << time << "\t\t| " << flops / 1e9 << "\n";
+        output << method << "," << time << "," << flops / 1e9 << "\n";
+    };
+
+    // Слева направо: промежуточное произведение dims[0] x dims[i + 1] в R
+    vector<double> R, T;
+    auto leftToRight = [&](auto&& mul)
+    {
+        R = M[0];
+        for (size_t i = 1; i < count; i++)
+        {
+            T.resize(dims[0] * dims[i + 1]);
+            mul(T.data(), R.data(), M[i].data(), dims[0], dims[i], dims[i + 1]);
+            R.swap(T);
+        }
+    };
+    report("left_to_right_256", measure([&]
+    {
+        leftToRight([](double* A, const double* B, const double* C, size_t m, size_t k, size_t cols)
+                    { mulMatrix256(A, B, C, cols, m, k, m, cols, k); });
+    }), plan.left_to_right_flops);
+    report("left_to_right_gemm", measure([&]
+    {
+        leftToRight([](double* A, const double* B, const double* C, size_t m, size_t k, size_t cols)
+                    { gemmParallel(m, cols, k, 1, B, m, C, k, 0, A, m); });
+    }), plan.left_to_right_flops);
+
+    vector<double> A(dims[0] * dims[count]);
+    chain_workspace workspace;
+    report("chain", measure([&] { multiplyChain(plan, operands, A.data(), dims[0], workspace); }), plan.flops);
+
+    // Другой порядок сложений - сравнение с относительной погрешностью
+    double diff = 0, norm = 0;
+    for (size_t i = 0; i < A.size(); i++)
+    {
+        diff = std::max(diff, std::abs(A[i] - R[i]));
+        norm = std::max(norm, std::abs(R[i]));
+    }
+    cout << "Relative difference: " << diff / norm << "\n";
+
+    output.close();
+    return 0;
+}
+
+// Режим "cblas": cblas_dgemm в разных расположениях против mulMatrix256, время - в output_cblas.csv
+int cblasMain(size_t n)
+{
+    std::ofstream output("../output_cblas.csv");
+
+    if (!output.is_open())
+    {
+        std::cout << "Couldn't open file!\n";
+        return -1;
+    }
+
+    // Небольшие целые и alpha, beta из половин - все варианты считаются точно
+    vector<double> A(n * n), B(n * n), C0(n * n), C(n * n), P(n * n), R(n * n);
+    for (size_t i = 0; i < n * n; i++)
+    {
+        A[i] = rand() % 19 - 9;
+        B[i] = rand() % 19 - 9;
+        C0[i] = rand() % 19 - 9;
+    }
+
+    auto measure = [&](auto&& run)
+    {
+        double total_time = 0;
+        for (int test = 0; test < num_tests; ++test)
+        {
+            C = C0;
+            auto t1 = chrono::steady_clock::now();
+            run();
+            auto t2 = chrono::steady_clock::now();
+            total_time += chrono::duration_cast<chrono::microseconds>(t2 - t1).count() / 1000.0;
+        }
+        return total_time / num_tests;
+    };
+
+    cout << "Method\t\t| Duration, ms\n";
+    output << "method,Duration\n";
+    auto report = [&](const string& method, double time)
+    {
+        cout << method << "\t\t| " << time << "\n";
+        output << method << "," << time << "\n";
+    };
+
+    // mulMatrix256 перезаписывает результат: alpha и beta - отдельным проходом
+    report("mulMatrix256", measure([&]
+    {
+        mulMatrix256(P.data(), A.data(), B.data(), n, n, n, n, n, n);
+        for (size_t i = 0; i < n * n; i++)
+        {
+            R[i] = 1.5 * P[i] + 0.5 * C[i];
+        }
+    }));
+
+    const int N = static_cast<int>(n);
+    auto check = [&](const string& method, const vector<double>& expected)
+    {
+        if (C == expected)
+            return true;
+        cout << "Wrong " << method << " result\n";
+        return false;
+    };
+
+    report("col_major", measure([&]
+    {
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, N, N, N, 1.5, A.data(), N, B.data(), N, 0.5, C.data(),
+                    N);
+    }));
+    if (!check("col-major", R))
+        return -1;
+
+    // По строкам та же память - транспонированные матрицы: B^T * A^T по строкам = A * B по столбцам
+    report("row_major", measure([&]
+    {
+        cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, N, N, N, 1.5, B.data(), N, A.data(), N, 0.5, C.data(),
+                    N);
+    }));
+    if (!check("row-major", R))
+        return -1;
+
+    // B^T * A^T = (A * B)^T
+    report("trans_trans", measure([&]
+    {
+        cblas_dgemm(CblasColMajor, CblasTrans, CblasTrans, N, N, N, 1.5, B.data(), N, A.data(), N, 0.5, C.data(),
+                    N);
+    }));
+    transpose(n, n, P.data(), n, R.data(), n);
+    for (size_t i = 0; i < n * n; i++)
+    {
+        R[i] = 1.5 * R[i] + 0.5 * C0[i];
+    }
+    if (!check("transposed", R))
+        return -1;
+
+    output.close();
+    return 0;
+}
+
+// Значение параметра --name=value из аргументов режима;
+// если значение не положительное целое, бросает std::invalid_argument
+size_t sizeOption(int argc, char** argv, const string& name, size_t fallback)
+{
+    const string prefix = "--" + name + "=";
+    for (int i = 2; i < argc; i++)
+    {
+        const string arg = argv[i];
+        if (arg.rfind(prefix, 0) == 0)
+        {
+            const char* first = arg.data() + prefix.size();
+            const char* last = arg.data() + arg.size();
+            size_t value = 0;
+            auto [ptr, error] = from_chars(first, last, value);
+            if (error != errc() || ptr != last || value == 0)
+                throw invalid_argument("--" + name + " must be a positive integer");
+            return value;
+        }
+    }
+    return fallback;
+}
+
 // Основная функция
 int main(int argc, char** argv)
 {
     srand(time(NULL)); // Инициализация генератора случайных чисел
 
+    // Настройка gemm, подобранная режимом autotune на этой машине
+    if (loadGemmProfile(gemmProfilePath()))
+        cout << "GEMM profile: " << gemmProfilePath() << "\n";
+
+    // Режим работы задаётся первым аргументом, без аргументов - сравнение вариантов умножения
+    const string mode = argc > 1 ? argv[1] : "";
+    try
+    {
+        if (mode == "parallel")
+            return parallelMain(sizeOption(argc, argv, "n", 2048));
+        if (mode == "strassen")
+            return strassenMain(sizeOption(argc, argv, "n", 2048), sizeOption(argc, argv, "cutoff", 128));
+        if (mode == "small")
+            return smallMain(sizeOption(argc, argv, "count", 20000));
+        if (mode == "refine")
+            return refineMain(sizeOption(argc, argv, "n", 2048));
+        if (mode == "lu")
+            return luMain(sizeOption(argc, argv, "n", 2048), sizeOption(argc, argv, "nb", 32));
+        if (mode == "transpose")
+            return transposeMain(sizeOption(argc, argv, "n", 2048));
+        if (mode == "chain")
+            return chainMain(sizeOption(argc, argv, "count", 10), sizeOption(argc, argv, "n", 512));
+        if (mode == "cblas")
+            return cblasMain(sizeOption(argc, argv, "n", 2048));
+        if (mode == "autotune")
+            return autotuneMain(sizeOption(argc, argv, "n", 1024));
+    }
+    catch (const invalid_argument& error) // Неверное значение параметра
+    {
+        cout << error.what() << "\n";
+        return -1;
+    }
+
     std::ofstream output("../output.csv"); // Открытие файла для записи результатов
 
     if (!output.is_open())
@@ -158,70 +1024,92 @@ int main(int argc, char** argv)
     };
 
     // Инициализация матриц
-    vector<double> A(matrixSize * matrixSize), D(matrixSize * matrixSize);
+    AlignedMatrix<double> A(matrixSize, matrixSize), D(matrixSize, matrixSize), E(matrixSize, matrixSize),
+            F(matrixSize, matrixSize);
 
     // Создание единичной и перестановочной матриц
     auto identity = getIdentityMatrix(matrixSize);
     auto permutation = getPermutationMatrix(matrixSize);
 
-    vector<double> B = identity;
-    vector<double> C = permutation;
+    AlignedMatrix<double> B(matrixSize, matrixSize), C(matrixSize, matrixSize);
+    B.assign(identity.data());
+    C.assign(permutation.data());
 
     // Векторы для хранения времени выполнения
     vector<double> scalar_times(num_tests);
     vector<double> vector_times(num_tests);
+    vector<double> packed_times(num_tests);
+    vector<double> structured_times(num_tests);
 
     // Цикл для 10 запусков
     for (int test = 0; test < num_tests; ++test)
     {
         // Скалярное умножение матриц
         auto t1 = chrono::steady_clock::now();
-        mulMatrix(A.data(), matrixSize, matrixSize,
-                  B.data(), matrixSize, matrixSize,
-                  C.data(), matrixSize, matrixSize);
+        mulMatrix(A, B, C);
         auto t2 = chrono::steady_clock::now();
         scalar_times[test] = chrono::duration_cast<chrono::milliseconds>(t2 - t1).count();
 
         // Векторизованное умножение матриц
         t1 = chrono::steady_clock::now();
-        mulMatrix256(D.data(), B.data(), C.data(), matrixSize, matrixSize, matrixSize, matrixSize, matrixSize,
-                     matrixSize);
+        mulMatrix256(D, B, C);
         t2 = chrono::steady_clock::now();
         vector_times[test] = chrono::duration_cast<chrono::milliseconds>(t2 - t1).count();
 
+        // Блочное умножение с упаковкой панелей
+        t1 = chrono::steady_clock::now();
+        mulMatrixPacked(E, B, C);
+        t2 = chrono::steady_clock::now();
+        packed_times[test] = chrono::duration_cast<chrono::milliseconds>(t2 - t1).count();
+
+        // Умножение с выбором ядра по структуре операндов
+        t1 = chrono::steady_clock::now();
+        multiply(F, B, C);
+        t2 = chrono::steady_clock::now();
+        structured_times[test] = chrono::duration_cast<chrono::microseconds>(t2 - t1).count() / 1000.0;
+
         // Сравнение результатов скалярного и векторного умножения
-        if (!std::memcmp(static_cast<void*>(A.data()),
-                         static_cast<void*>(D.data()),
-                         matrixSize * matrixSize * sizeof(double)))
+        if (A == D && A == E && A == F) // memcmp по столбцам, без дополнения
         {
             cout << "Test " << test << " :" << "The results of matrix multiplication are the same! \n" << "Scalar_times: " <<
-                    scalar_times[test] << "\n" << "Vector_times: " << vector_times[test] << "\n";
+                    scalar_times[test] << "\n" << "Vector_times: " << vector_times[test] << "\n" << "Packed_times: " <<
+                    packed_times[test] << "\n" << "Structured_times: " << structured_times[test] << "\n";
         }
     }
 
     // Вычисление среднего времени выполнения
     double avg_scalar_time = 0;
     double avg_vector_time = 0;
+    double avg_packed_time = 0;
+    double avg_structured_time = 0;
 
     for (int test = 0; test < num_tests; ++test)
     {
         avg_scalar_time += scalar_times[test];
         avg_vector_time += vector_times[test];
+        avg_packed_time += packed_times[test];
+        avg_structured_time += structured_times[test];
     }
 
     avg_scalar_time /= num_tests;
     avg_vector_time /= num_tests;
+    avg_packed_time /= num_tests;
+    avg_structured_time /= num_tests;
 
     // Запись результатов в файл
-    output << "test,scalar,vector,avg_scalar,avg_vector\n";
+    output << "test,scalar,vector,packed,structured,avg_scalar,avg_vector,avg_packed,avg_structured\n";
     for (int test = 0; test < num_tests; ++test)
     {
-        output << test << "," << scalar_times[test] << "," << vector_times[test] << "," << avg_scalar_time << "," << avg_vector_time << "\n";
+        output << test << "," << scalar_times[test] << "," << vector_times[test] << "," << packed_times[test] << ","
+               << structured_times[test] << "," << avg_scalar_time << "," << avg_vector_time << "," << avg_packed_time
+               << "," << avg_structured_time << "\n";
     }
 
     // Вывод среднего времени выполнения
     cout << "Average Scalar Time: " << avg_scalar_time << " ms\n";
     cout << "Average Vector Time: " << avg_vector_time << " ms\n";
+    cout << "Average Packed Time: " << avg_packed_time << " ms\n";
+    cout << "Average Structured Time: " << avg_structured_time << " ms\n";
 
     output.close();
     return 0;
@@ -0,0 +1,35 @@
+/* Выбор ядра малых матриц по размеру: таблица smallGemmBatch<n, n, n> для n = 1..small_gemm_max. */
+
+#include "small_gemm.h"
+#include "gemm.h"
+#include <array>
+
+namespace
+{
+    using batch_kernel = void (*)(std::size_t, double*, const double*, const double*);
+
+    template <std::size_t... I>
+    constexpr std::array<batch_kernel, sizeof...(I)> makeKernels(std::index_sequence<I...>)
+    {
+        return {&smallGemmBatch<I + 1, I + 1, I + 1>...};
+    }
+
+    constexpr auto kernels = makeKernels(std::make_index_sequence<small_gemm_max>{});
+}
+
+void smallGemmBatch(std::size_t n, std::size_t count, double* A, const double* B, const double* C)
+{
+    if (n == 0)
+        return;
+    if (n <= small_gemm_max)
+    {
+        kernels[n - 1](count, A, B, C);
+        return;
+    }
+
+#pragma omp parallel for schedule(static)
+    for (std::size_t b = 0; b < count; b++)
+    {
+        gemm(n, n, n, 1, B + b * n * n, n, C + b * n * n, n, 0, A + b * n * n, n);
+    }
+}
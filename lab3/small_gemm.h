@@ -0,0 +1,135 @@
+/* Умножение малых матриц с размерами времени компиляции - основные моменты:
+    Обозначения как в gemm.h: A = B * C, матрицы по столбцам без дополнения
+    (A - M x N, B - M x K, C - K x N, ведущие размерности M, M и K).
+
+    Ядро smallGemm<M, N, K>:
+        * столбец A считается в регистрах: (M + lanes - 1) / lanes пакетов, на каждом шаге по k -
+          загрузка столбца B, broadcast элемента C и FMA;
+        * циклы по k и по пакетам столбца полностью развёрнуты (unroll), размеры - константы;
+        * последний неполный пакет столбца читается и пишется по маске, за концом матрицы
+          ничего не трогается - подходит для массивов матриц, лежащих подряд.
+
+    Пакетный вариант smallGemmBatch - массивы count матриц подряд, матрицы делятся между
+    потоками OpenMP. Для квадратных матриц 1..32 есть выбор ядра по размеру во время выполнения,
+    остальные размеры считаются через gemm. */
+
+#pragma once
+#include <immintrin.h>
+#include <cstddef>
+#include <utility>
+
+namespace small_detail
+{
+#ifdef __AVX512F__
+    struct vec
+    {
+        using type = __m512d;
+        static constexpr std::size_t lanes = 8;
+        static __m512d zero() { return _mm512_setzero_pd(); }
+        static __m512d set1(double v) { return _mm512_set1_pd(v); }
+        static __m512d load(const double* p) { return _mm512_loadu_pd(p); }
+        static void store(double* p, __m512d v) { _mm512_storeu_pd(p, v); }
+        static __m512d fmadd(__m512d a, __m512d b, __m512d c) { return _mm512_fmadd_pd(a, b, c); }
+
+        // Первые count элементов (count < lanes)
+        static __m512d loadFirst(const double* p, std::size_t count)
+        {
+            return _mm512_maskz_loadu_pd(static_cast<__mmask8>((1u << count) - 1), p);
+        }
+        static void storeFirst(double* p, __m512d v, std::size_t count)
+        {
+            _mm512_mask_storeu_pd(p, static_cast<__mmask8>((1u << count) - 1), v);
+        }
+    };
+#else
+    struct vec
+    {
+        using type = __m256d;
+        static constexpr std::size_t lanes = 4;
+        static __m256d zero() { return _mm256_setzero_pd(); }
+        static __m256d set1(double v) { return _mm256_set1_pd(v); }
+        static __m256d load(const double* p) { return _mm256_loadu_pd(p); }
+        static void store(double* p, __m256d v) { _mm256_storeu_pd(p, v); }
+        static __m256d fmadd(__m256d a, __m256d b, __m256d c) { return _mm256_fmadd_pd(a, b, c); }
+
+        static __m256i mask(std::size_t count)
+        {
+            return _mm256_cmpgt_epi64(_mm256_set1_epi64x(count), _mm256_set_epi64x(3, 2, 1, 0));
+        }
+        static __m256d loadFirst(const double* p, std::size_t count) { return _mm256_maskload_pd(p, mask(count)); }
+        static void storeFirst(double* p, __m256d v, std::size_t count) { _mm256_maskstore_pd(p, mask(count), v); }
+    };
+#endif
+
+    // f(integral_constant<0>), ..., f(integral_constant<Count - 1>) без цикла
+    template <std::size_t Count, class F>
+    inline void unroll(F&& f)
+    {
+        [&]<std::size_t... I>(std::index_sequence<I...>)
+        {
+            (f(std::integral_constant<std::size_t, I>{}), ...);
+        }(std::make_index_sequence<Count>{});
+    }
+
+    // Пакет Chunk столбца длины M: полный или по маске
+    template <std::size_t M, std::size_t Chunk>
+    inline vec::type loadChunk(const double* column)
+    {
+        constexpr std::size_t first = Chunk * vec::lanes;
+        if constexpr (first + vec::lanes <= M)
+            return vec::load(column + first);
+        else
+            return vec::loadFirst(column + first, M - first);
+    }
+
+    template <std::size_t M, std::size_t Chunk>
+    inline void storeChunk(double* column, vec::type v)
+    {
+        constexpr std::size_t first = Chunk * vec::lanes;
+        if constexpr (first + vec::lanes <= M)
+            vec::store(column + first, v);
+        else
+            vec::storeFirst(column + first, v, M - first);
+    }
+}
+
+// A = B * C для одной тройки матриц
+template <std::size_t M, std::size_t N, std::size_t K>
+inline void smallGemm(double* A, const double* B, const double* C)
+{
+    using small_detail::vec;
+    constexpr std::size_t chunks = (M + vec::lanes - 1) / vec::lanes;
+
+    for (std::size_t j = 0; j < N; j++)
+    {
+        vec::type acc[chunks];
+        small_detail::unroll<chunks>([&](auto c) { acc[c] = vec::zero(); });
+
+        small_detail::unroll<K>(
+            [&](auto p)
+            {
+                const vec::type cpj = vec::set1(C[j * K + p]);
+                small_detail::unroll<chunks>(
+                    [&](auto c) { acc[c] = vec::fmadd(small_detail::loadChunk<M, c>(B + p * M), cpj, acc[c]); });
+            });
+
+        small_detail::unroll<chunks>([&](auto c) { small_detail::storeChunk<M, c>(A + j * M, acc[c]); });
+    }
+}
+
+// A[b] = B[b] * C[b] для count матриц, лежащих подряд
+template <std::size_t M, std::size_t N, std::size_t K>
+void smallGemmBatch(std::size_t count, double* A, const double* B, const double* C)
+{
+#pragma omp parallel for schedule(static)
+    for (std::size_t b = 0; b < count; b++)
+    {
+        smallGemm<M, N, K>(A + b * M * N, B + b * M * K, C + b * K * N);
+    }
+}
+
+// Наибольший размер квадратных матриц с готовым ядром
+constexpr std::size_t small_gemm_max = 32;
+
+// Пакетное умножение квадратных матриц n x n: ядро smallGemm<n, n, n> при n <= small_gemm_max, иначе gemm
+void smallGemmBatch(std::size_t n, std::size_t count, double* A, const double* B, const double* C);
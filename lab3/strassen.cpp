@@ -0,0 +1,218 @@
+/* Реализация умножения Штрассена - Винограда.
+    * winograd - последовательная схема с тремя временными блоками: часть произведений
+      сразу пишется в четверти A и там же складывается.
+    * winogradTasks - семь произведений как задачи OpenMP, у каждого свои операнды и результат.
+    * multiply - выбор между листом и рекурсией, отщипывание нечётных размерностей. */
+
+#include "strassen.h"
+#include "gemm.h"
+#include <omp.h>
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+    // Z = X + sign * Y для блоков m x n; team - всей командой потоков (вне задач)
+    void addBlocks(std::size_t m, std::size_t n, const double* X, std::size_t ldx, const double* Y, std::size_t ldy,
+                   double sign, double* Z, std::size_t ldz, bool team)
+    {
+#pragma omp parallel for if (team)
+        for (std::size_t j = 0; j < n; j++)
+        {
+            for (std::size_t i = 0; i < m; i++)
+            {
+                Z[j * ldz + i] = X[j * ldx + i] + sign * Y[j * ldy + i];
+            }
+        }
+    }
+
+    bool isLeaf(std::size_t m, std::size_t n, std::size_t k, std::size_t cutoff)
+    {
+        return std::min({m, n, k}) <= cutoff;
+    }
+
+    // Рабочая память последовательной схемы: три временных блока на уровень
+    std::size_t sequentialSize(std::size_t m, std::size_t n, std::size_t k, std::size_t cutoff)
+    {
+        if (isLeaf(m, n, k, cutoff))
+            return 0;
+        const std::size_t m2 = m / 2, n2 = n / 2, k2 = k / 2;
+        return m2 * k2 + k2 * n2 + m2 * n2 + sequentialSize(m2, n2, k2, cutoff);
+    }
+
+    // Рабочая память схемы с задачами: S1..S4, T1..T4, три результата и память семи подзадач
+    std::size_t taskSize(std::size_t m, std::size_t n, std::size_t k, std::size_t cutoff)
+    {
+        if (isLeaf(m, n, k, cutoff))
+            return 0;
+        const std::size_t m2 = m / 2, n2 = n / 2, k2 = k / 2;
+        return 4 * m2 * k2 + 4 * k2 * n2 + 3 * m2 * n2 + 7 * sequentialSize(m2, n2, k2, cutoff);
+    }
+
+    // Лист рекурсии: A = B * C + beta * A блочным умножением
+    void leaf(std::size_t m, std::size_t n, std::size_t k, const double* B, std::size_t ldb, const double* C,
+              std::size_t ldc, double beta, double* A, std::size_t lda, bool team)
+    {
+        if (team)
+            gemmParallel(m, n, k, 1, B, ldb, C, ldc, beta, A, lda);
+        else
+            gemm(m, n, k, 1, B, ldb, C, ldc, beta, A, lda);
+    }
+
+    void multiply(std::size_t m, std::size_t n, std::size_t k, const double* B, std::size_t ldb, const double* C,
+                  std::size_t ldc, double* A, std::size_t lda, std::size_t cutoff, double* work, bool team,
+                  bool tasks);
+
+    // Последовательная схема для чётных m, n, k
+    void winograd(std::size_t m, std::size_t n, std::size_t k, const double* B, std::size_t ldb, const double* C,
+                  std::size_t ldc, double* A, std::size_t lda, std::size_t cutoff, double* work, bool team)
+    {
+        const std::size_t m2 = m / 2, n2 = n / 2, k2 = k / 2;
+        const double *B11 = B, *B21 = B + m2, *B12 = B + k2 * ldb, *B22 = B12 + m2;
+        const double *C11 = C, *C21 = C + k2, *C12 = C + n2 * ldc, *C22 = C12 + k2;
+        double *A11 = A, *A21 = A + m2, *A12 = A + n2 * lda, *A22 = A12 + m2;
+
+        double* X = work;         // m2 x k2 - суммы четвертей B
+        double* Y = X + m2 * k2;  // k2 x n2 - суммы четвертей C
+        double* Z = Y + k2 * n2;  // m2 x n2 - P1
+        double* next = Z + m2 * n2;
+
+        auto product = [&](const double* L, std::size_t ldl, const double* R, std::size_t ldr, double* P,
+                           std::size_t ldp) { multiply(m2, n2, k2, L, ldl, R, ldr, P, ldp, cutoff, next, team, false); };
+
+        addBlocks(m2, k2, B11, ldb, B21, ldb, -1, X, m2, team);    // S3 = B11 - B21
+        addBlocks(k2, n2, C22, ldc, C12, ldc, -1, Y, k2, team);    // T3 = C22 - C12
+        product(X, m2, Y, k2, A21, lda);                           // P7 = S3 * T3
+        addBlocks(m2, k2, B21, ldb, B22, ldb, 1, X, m2, team);     // S1 = B21 + B22
+        addBlocks(k2, n2, C12, ldc, C11, ldc, -1, Y, k2, team);    // T1 = C12 - C11
+        product(X, m2, Y, k2, A22, lda);                           // P5 = S1 * T1
+        addBlocks(m2, k2, X, m2, B11, ldb, -1, X, m2, team);       // S2 = S1 - B11
+        addBlocks(k2, n2, C22, ldc, Y, k2, -1, Y, k2, team);       // T2 = C22 - T1
+        product(X, m2, Y, k2, A12, lda);                           // P6 = S2 * T2
+        product(B11, ldb, C11, ldc, Z, m2);                        // P1 = B11 * C11
+        addBlocks(m2, n2, A12, lda, Z, m2, 1, A12, lda, team);     // U2 = P1 + P6
+        addBlocks(m2, n2, A21, lda, A12, lda, 1, A21, lda, team);  // U3 = U2 + P7
+        addBlocks(m2, n2, A12, lda, A22, lda, 1, A12, lda, team);  // U4 = U2 + P5
+        addBlocks(m2, n2, A22, lda, A21, lda, 1, A22, lda, team);  // A22 = U7 = U3 + P5
+        addBlocks(m2, k2, B12, ldb, X, m2, -1, X, m2, team);       // S4 = B12 - S2
+        product(X, m2, C22, ldc, A11, lda);                        // P3 = S4 * C22
+        addBlocks(m2, n2, A12, lda, A11, lda, 1, A12, lda, team);  // A12 = U5 = U4 + P3
+        addBlocks(k2, n2, Y, k2, C21, ldc, -1, Y, k2, team);       // T4 = T2 - C21
+        product(B22, ldb, Y, k2, A11, lda);                        // P4 = B22 * T4
+        addBlocks(m2, n2, A21, lda, A11, lda, -1, A21, lda, team); // A21 = U6 = U3 - P4
+        product(B12, ldb, C21, ldc, A11, lda);                     // P2 = B12 * C21
+        addBlocks(m2, n2, A11, lda, Z, m2, 1, A11, lda, team);     // A11 = U1 = P1 + P2
+    }
+
+    // Семь произведений верхнего уровня - задачи OpenMP; m, n, k чётные
+    void winogradTasks(std::size_t m, std::size_t n, std::size_t k, const double* B, std::size_t ldb,
+                       const double* C, std::size_t ldc, double* A, std::size_t lda, std::size_t cutoff, double* work)
+    {
+        const std::size_t m2 = m / 2, n2 = n / 2, k2 = k / 2;
+        const double *B11 = B, *B21 = B + m2, *B12 = B + k2 * ldb, *B22 = B12 + m2;
+        const double *C11 = C, *C21 = C + k2, *C12 = C + n2 * ldc, *C22 = C12 + k2;
+        double *A11 = A, *A21 = A + m2, *A12 = A + n2 * lda, *A22 = A12 + m2;
+
+        double *S1 = work, *S2 = S1 + m2 * k2, *S3 = S2 + m2 * k2, *S4 = S3 + m2 * k2;
+        double *T1 = S4 + m2 * k2, *T2 = T1 + k2 * n2, *T3 = T2 + k2 * n2, *T4 = T3 + k2 * n2;
+        double *P1 = T4 + k2 * n2, *P2 = P1 + m2 * n2, *P4 = P2 + m2 * n2;
+        double* next = P4 + m2 * n2;
+        const std::size_t childSize = sequentialSize(m2, n2, k2, cutoff);
+
+        addBlocks(m2, k2, B21, ldb, B22, ldb, 1, S1, m2, true);
+        addBlocks(m2, k2, S1, m2, B11, ldb, -1, S2, m2, true);
+        addBlocks(m2, k2, B11, ldb, B21, ldb, -1, S3, m2, true);
+        addBlocks(m2, k2, B12, ldb, S2, m2, -1, S4, m2, true);
+        addBlocks(k2, n2, C12, ldc, C11, ldc, -1, T1, k2, true);
+        addBlocks(k2, n2, C22, ldc, T1, k2, -1, T2, k2, true);
+        addBlocks(k2, n2, C22, ldc, C12, ldc, -1, T3, k2, true);
+        addBlocks(k2, n2, T2, k2, C21, ldc, -1, T4, k2, true);
+
+        // Четыре произведения пишутся сразу в четверти A, остальные три - в P1, P2, P4
+        struct product_t
+        {
+            const double* L;
+            std::size_t ldl;
+            const double* R;
+            std::size_t ldr;
+            double* P;
+            std::size_t ldp;
+        };
+        const product_t products[7] = {
+            {B11, ldb, C11, ldc, P1, m2}, {B12, ldb, C21, ldc, P2, m2}, {S4, m2, C22, ldc, A11, lda},
+            {B22, ldb, T4, k2, P4, m2},   {S1, m2, T1, k2, A22, lda},   {S2, m2, T2, k2, A12, lda},
+            {S3, m2, T3, k2, A21, lda}};
+
+#pragma omp parallel
+#pragma omp single
+        {
+            for (std::size_t i = 0; i < 7; i++)
+            {
+#pragma omp task firstprivate(i)
+                {
+                    const product_t& p = products[i];
+                    multiply(m2, n2, k2, p.L, p.ldl, p.R, p.ldr, p.P, p.ldp, cutoff, next + i * childSize, false,
+                             false);
+                }
+            }
+        }
+
+        addBlocks(m2, n2, A12, lda, P1, m2, 1, A12, lda, true);   // U2 = P1 + P6
+        addBlocks(m2, n2, A21, lda, A12, lda, 1, A21, lda, true); // U3 = U2 + P7
+        addBlocks(m2, n2, A12, lda, A22, lda, 1, A12, lda, true); // U4 = U2 + P5
+        addBlocks(m2, n2, A22, lda, A21, lda, 1, A22, lda, true); // A22 = U7 = U3 + P5
+        addBlocks(m2, n2, A12, lda, A11, lda, 1, A12, lda, true); // A12 = U5 = U4 + P3
+        addBlocks(m2, n2, A21, lda, P4, m2, -1, A21, lda, true);  // A21 = U6 = U3 - P4
+        addBlocks(m2, n2, P1, m2, P2, m2, 1, A11, lda, true);     // A11 = U1 = P1 + P2
+    }
+
+    void multiply(std::size_t m, std::size_t n, std::size_t k, const double* B, std::size_t ldb, const double* C,
+                  std::size_t ldc, double* A, std::size_t lda, std::size_t cutoff, double* work, bool team, bool tasks)
+    {
+        if (isLeaf(m, n, k, cutoff))
+        {
+            leaf(m, n, k, B, ldb, C, ldc, 0, A, lda, team);
+            return;
+        }
+
+        // Рекурсия по чётной части, остаток - отдельными умножениями
+        const std::size_t me = m & ~std::size_t{1}, ne = n & ~std::size_t{1}, ke = k & ~std::size_t{1};
+        if (tasks)
+            winogradTasks(me, ne, ke, B, ldb, C, ldc, A, lda, cutoff, work);
+        else
+            winograd(me, ne, ke, B, ldb, C, ldc, A, lda, cutoff, work, team);
+
+        if (ke < k) // Ранг-1 поправка от последнего столбца B и последней строки C
+            leaf(me, ne, 1, B + ke * ldb, ldb, C + ke, ldc, 1, A, lda, team);
+        if (me < m) // Последняя строка A
+            leaf(1, n, k, B + me, ldb, C, ldc, 0, A + me, lda, team);
+        if (ne < n) // Последний столбец A без последней строки
+            leaf(me, 1, k, B, ldb, C + ne * ldc, ldc, 0, A + ne * lda, lda, team);
+    }
+}
+
+std::size_t strassenWorkspace(std::size_t m, std::size_t n, std::size_t k, std::size_t cutoff)
+{
+    // Схеме с задачами нужно больше памяти, чем последовательной, - хватит на любую
+    return taskSize(m, n, k, std::max<std::size_t>(cutoff, 1));
+}
+
+void strassen(std::size_t m, std::size_t n, std::size_t k, const double* B, std::size_t ldb, const double* C,
+              std::size_t ldc, double* A, std::size_t lda, std::size_t cutoff, double* workspace)
+{
+    const bool team = !omp_in_parallel();
+    const bool tasks = team && omp_get_max_threads() > 1;
+    multiply(m, n, k, B, ldb, C, ldc, A, lda, std::max<std::size_t>(cutoff, 1), workspace, team, tasks);
+}
+
+void mulMatrixStrassen(AlignedMatrix<double>& A, const AlignedMatrix<double>& B, const AlignedMatrix<double>& C,
+                       std::size_t cutoff, std::vector<double>& workspace)
+{
+    const std::size_t m = A.cols(), n = A.rows(), k = B.rows();
+    assert(B.cols() == m && C.cols() == k && C.rows() == n);
+
+    const std::size_t size = strassenWorkspace(m, n, k, cutoff);
+    if (workspace.size() < size)
+        workspace.resize(size);
+    strassen(m, n, k, B.data(), B.stride(), C.data(), C.stride(), A.data(), A.stride(), cutoff, workspace.data());
+}
@@ -0,0 +1,39 @@
+/* Умножение по схеме Штрассена - Винограда - основные моменты:
+    Обозначения как в gemm.h: A = B * C, матрицы по столбцам, ld* - ведущие размерности.
+
+    Рекурсия:
+        Матрицы делятся на четверти, произведение считается через 7 умножений четвертей
+        и 15 сложений (вариант Винограда) вместо 8 умножений - O(n^2.81) вместо O(n^3).
+        Рекурсия идёт, пока наименьшая из размерностей m, n, k больше cutoff, дальше -
+        блочное умножение gemm / gemmParallel. Нечётная размерность отщипывается:
+        последняя строка, столбец или ранг-1 поправка считаются через gemm.
+
+    Параллельность:
+        * Если потоков OpenMP больше одного, на верхнем уровне семь произведений -
+          задачи OpenMP, каждая со своими временными блоками и обычным gemm в листьях;
+        * ниже, а также при одном потоке, произведения идут по очереди с тремя временными
+          блоками на уровень, листья - gemmParallel всей командой.
+
+    Рабочая память:
+        Все временные блоки берутся из workspace размером strassenWorkspace(m, n, k, cutoff)
+        элементов - внутри умножения память не выделяется.
+
+    Точность:
+        Погрешность растёт с глубиной рекурсии (сложения четвертей теряют младшие разряды),
+        оценка - в режиме ./lab3 strassen, сравнение с mulMatrix. */
+
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "../common/aligned_matrix.h"
+
+// Размер рабочей памяти в элементах double
+std::size_t strassenWorkspace(std::size_t m, std::size_t n, std::size_t k, std::size_t cutoff);
+
+// A = B * C; workspace - не меньше strassenWorkspace(m, n, k, cutoff) элементов
+void strassen(std::size_t m, std::size_t n, std::size_t k, const double* B, std::size_t ldb, const double* C,
+              std::size_t ldc, double* A, std::size_t lda, std::size_t cutoff, double* workspace);
+
+// Умножение выровненных матриц; workspace при нехватке увеличивается и переиспользуется между вызовами
+void mulMatrixStrassen(AlignedMatrix<double>& A, const AlignedMatrix<double>& B, const AlignedMatrix<double>& C,
+                       std::size_t cutoff, std::vector<double>& workspace);
@@ -0,0 +1,325 @@
+/* Реализация умножения с учётом структуры операндов.
+    * classify - один проход по столбцам с подсчётом ненулевых и проверкой единиц.
+    * Ядра копирования, сбора и масштабирования - параллельно по столбцам A (OpenMP).
+    * spmm / spmmTransposed - разреженное умножение, столбец A на поток. */
+
+#include "structured.h"
+#include "gemm.h"
+#include <cassert>
+#include <cstring>
+
+namespace
+{
+    // Строка единицы в каждом столбце перестановочной матрицы
+    std::vector<std::size_t> permutationRows(const AlignedMatrix<double>& P)
+    {
+        std::vector<std::size_t> rows(P.rows());
+        for (std::size_t j = 0; j < P.rows(); j++)
+        {
+            const double* column = P.row(j);
+            std::size_t i = 0;
+            while (column[i] == 0)
+                i++;
+            rows[j] = i;
+        }
+        return rows;
+    }
+
+    // Столбцы A - копии столбцов source[j]
+    void copyColumns(AlignedMatrix<double>& A, const AlignedMatrix<double>& B, const std::vector<std::size_t>& source)
+    {
+#pragma omp parallel for
+        for (std::size_t j = 0; j < A.rows(); j++)
+        {
+            std::memcpy(A.row(j), B.row(source[j]), A.cols() * sizeof(double));
+        }
+    }
+
+    // A(i, j) = C(rowOf[i], j) - сбор строк
+    void gatherRows(AlignedMatrix<double>& A, const std::vector<std::size_t>& rowOf, const AlignedMatrix<double>& C)
+    {
+#pragma omp parallel for
+        for (std::size_t j = 0; j < A.rows(); j++)
+        {
+            double* a = A.row(j);
+            const double* c = C.row(j);
+            for (std::size_t i = 0; i < A.cols(); i++)
+            {
+                a[i] = c[rowOf[i]];
+            }
+        }
+    }
+
+    // A(i, j) = d[i] * C(i, j) - масштабирование строк
+    void scaleRows(AlignedMatrix<double>& A, const std::vector<double>& d, const AlignedMatrix<double>& C)
+    {
+#pragma omp parallel for
+        for (std::size_t j = 0; j < A.rows(); j++)
+        {
+            double* a = A.row(j);
+            const double* c = C.row(j);
+            for (std::size_t i = 0; i < A.cols(); i++)
+            {
+                a[i] = d[i] * c[i];
+            }
+        }
+    }
+
+    // A(i, j) = B(i, j) * d[j] - масштабирование столбцов
+    void scaleColumns(AlignedMatrix<double>& A, const AlignedMatrix<double>& B, const std::vector<double>& d)
+    {
+#pragma omp parallel for
+        for (std::size_t j = 0; j < A.rows(); j++)
+        {
+            double* a = A.row(j);
+            const double* b = B.row(j);
+            for (std::size_t i = 0; i < A.cols(); i++)
+            {
+                a[i] = b[i] * d[j];
+            }
+        }
+    }
+
+    std::vector<double> diagonalOf(const AlignedMatrix<double>& D)
+    {
+        std::vector<double> d(D.rows());
+        for (std::size_t j = 0; j < D.rows(); j++)
+        {
+            d[j] = D(j, j);
+        }
+        return d;
+    }
+}
+
+const char* kindName(matrix_kind kind)
+{
+    switch (kind)
+    {
+    case matrix_kind::identity:
+        return "identity";
+    case matrix_kind::diagonal:
+        return "diagonal";
+    case matrix_kind::permutation:
+        return "permutation";
+    case matrix_kind::sparse:
+        return "sparse";
+    default:
+        return "dense";
+    }
+}
+
+matrix_kind classify(const AlignedMatrix<double>& M, double sparseDensity)
+{
+    const std::size_t m = M.cols(), n = M.rows(); // Строк и столбцов матрицы
+    const std::size_t limit = static_cast<std::size_t>(sparseDensity * m * n);
+
+    bool identity = m == n, diagonal = m == n, permutation = m == n;
+    std::vector<char> rowUsed(permutation ? m : 0);
+    std::size_t nnz = 0;
+
+    for (std::size_t j = 0; j < n; j++)
+    {
+        const double* column = M.row(j);
+        std::size_t count = 0, last = 0;
+        for (std::size_t i = 0; i < m; i++)
+        {
+            if (column[i] != 0)
+            {
+                count++;
+                last = i;
+            }
+        }
+        nnz += count;
+
+        const bool diagonalColumn = count == 0 || (count == 1 && last == j);
+        diagonal = diagonal && diagonalColumn;
+        identity = identity && count == 1 && last == j && column[j] == 1;
+        if (permutation)
+        {
+            permutation = count == 1 && column[last] == 1 && !rowUsed[last];
+            if (permutation)
+                rowUsed[last] = 1;
+        }
+
+        // Плотная: структуры уже нет, ненулевых больше порога
+        if (!diagonal && !permutation && nnz > limit)
+            return matrix_kind::dense;
+    }
+
+    if (identity)
+        return matrix_kind::identity;
+    if (permutation)
+        return matrix_kind::permutation;
+    if (diagonal)
+        return matrix_kind::diagonal;
+    return nnz <= limit ? matrix_kind::sparse : matrix_kind::dense;
+}
+
+csr_matrix toCsr(const AlignedMatrix<double>& M)
+{
+    csr_matrix S;
+    S.rows = M.cols();
+    S.cols = M.rows();
+    S.start.assign(S.rows + 1, 0);
+
+    // Количество ненулевых в строках, затем префиксные суммы
+    for (std::size_t j = 0; j < S.cols; j++)
+    {
+        const double* column = M.row(j);
+        for (std::size_t i = 0; i < S.rows; i++)
+        {
+            if (column[i] != 0)
+                S.start[i + 1]++;
+        }
+    }
+    for (std::size_t i = 0; i < S.rows; i++)
+    {
+        S.start[i + 1] += S.start[i];
+    }
+
+    S.index.resize(S.start[S.rows]);
+    S.values.resize(S.start[S.rows]);
+    std::vector<std::size_t> next(S.start.begin(), S.start.end() - 1);
+    for (std::size_t j = 0; j < S.cols; j++) // Столбцы по возрастанию - номера в строке упорядочены
+    {
+        const double* column = M.row(j);
+        for (std::size_t i = 0; i < S.rows; i++)
+        {
+            if (column[i] != 0)
+            {
+                S.index[next[i]] = j;
+                S.values[next[i]++] = column[i];
+            }
+        }
+    }
+    return S;
+}
+
+csr_matrix toCsrTransposed(const AlignedMatrix<double>& M)
+{
+    csr_matrix S;
+    S.rows = M.rows();
+    S.cols = M.cols();
+    S.start.reserve(S.rows + 1);
+    S.start.push_back(0);
+
+    for (std::size_t j = 0; j < S.rows; j++)
+    {
+        const double* column = M.row(j);
+        for (std::size_t i = 0; i < S.cols; i++)
+        {
+            if (column[i] != 0)
+            {
+                S.index.push_back(i);
+                S.values.push_back(column[i]);
+            }
+        }
+        S.start.push_back(S.index.size());
+    }
+    return S;
+}
+
+void spmm(AlignedMatrix<double>& A, const csr_matrix& B, const AlignedMatrix<double>& C)
+{
+    assert(A.cols() == B.rows && C.cols() == B.cols && A.rows() == C.rows());
+
+#pragma omp parallel for
+    for (std::size_t j = 0; j < A.rows(); j++)
+    {
+        double* a = A.row(j);
+        const double* c = C.row(j);
+        for (std::size_t i = 0; i < B.rows; i++)
+        {
+            double sum = 0;
+            for (std::size_t q = B.start[i]; q < B.start[i + 1]; q++)
+            {
+                sum += B.values[q] * c[B.index[q]];
+            }
+            a[i] = sum;
+        }
+    }
+}
+
+void spmmTransposed(AlignedMatrix<double>& A, const AlignedMatrix<double>& B, const csr_matrix& Ct)
+{
+    assert(A.cols() == B.cols() && B.rows() == Ct.cols && A.rows() == Ct.rows);
+
+    // Столбец j матрицы A - сумма столбцов B с весами из столбца j матрицы C
+#pragma omp parallel for
+    for (std::size_t j = 0; j < A.rows(); j++)
+    {
+        double* a = A.row(j);
+        std::memset(a, 0, A.cols() * sizeof(double));
+        for (std::size_t q = Ct.start[j]; q < Ct.start[j + 1]; q++)
+        {
+            const double* b = B.row(Ct.index[q]);
+            const double v = Ct.values[q];
+            for (std::size_t i = 0; i < A.cols(); i++)
+            {
+                a[i] += v * b[i];
+            }
+        }
+    }
+}
+
+void multiply(AlignedMatrix<double>& A, const AlignedMatrix<double>& B, const AlignedMatrix<double>& C,
+              double sparseDensity)
+{
+    assert(A.cols() == B.cols() && B.rows() == C.cols() && A.rows() == C.rows());
+
+    std::vector<std::size_t> same(A.rows());
+    for (std::size_t j = 0; j < same.size(); j++)
+    {
+        same[j] = j;
+    }
+
+    const matrix_kind kindB = classify(B, sparseDensity);
+    switch (kindB)
+    {
+    case matrix_kind::identity:
+        copyColumns(A, C, same);
+        return;
+    case matrix_kind::permutation:
+    {
+        // Единица столбца p стоит в строке rows[p], поэтому строка A с этим номером - строка p матрицы C
+        const std::vector<std::size_t> rows = permutationRows(B);
+        std::vector<std::size_t> rowOf(rows.size());
+        for (std::size_t p = 0; p < rows.size(); p++)
+        {
+            rowOf[rows[p]] = p;
+        }
+        gatherRows(A, rowOf, C);
+        return;
+    }
+    case matrix_kind::diagonal:
+        scaleRows(A, diagonalOf(B), C);
+        return;
+    default:
+        break;
+    }
+
+    switch (classify(C, sparseDensity))
+    {
+    case matrix_kind::identity:
+        copyColumns(A, B, same);
+        return;
+    case matrix_kind::permutation:
+        copyColumns(A, B, permutationRows(C));
+        return;
+    case matrix_kind::diagonal:
+        scaleColumns(A, B, diagonalOf(C));
+        return;
+    case matrix_kind::sparse:
+        spmmTransposed(A, B, toCsrTransposed(C));
+        return;
+    default:
+        break;
+    }
+
+    // Разреженная B проверяется после структурной C: сбор или масштабирование дешевле spmm
+    if (kindB == matrix_kind::sparse)
+        spmm(A, toCsr(B), C);
+    else
+        gemmParallel(A.cols(), A.rows(), B.rows(), 1, B.data(), B.stride(), C.data(), C.stride(), 0, A.data(),
+                     A.stride());
+}
@@ -0,0 +1,63 @@
+/* Умножение с учётом структуры операндов - основные моменты:
+    Обозначения как в gemm.h: A = B * C, матрицы по столбцам в AlignedMatrix
+    ("строка" контейнера - столбец матрицы).
+
+    Классификация (classify) - один проход по матрице, O(n^2), с ранним выходом для плотных:
+        * identity    - единичная;
+        * diagonal    - ненулевые элементы только на диагонали;
+        * permutation - в каждой строке и каждом столбце ровно одна единица;
+        * sparse      - доля ненулевых элементов не больше порога sparseDensity;
+        * dense       - всё остальное.
+
+    Умножение (multiply) выбирает ядро по виду операндов, сначала по B, затем по C:
+        * единичная - копирование столбцов другого операнда;
+        * перестановочная - сбор строк C (B - перестановка) или копирование столбцов B (C - перестановка);
+        * диагональная - масштабирование строк C или столбцов B;
+        * разреженная B - CSR x плотная (spmm), разреженная C - плотная x CSR от C^T (spmmTransposed);
+        * иначе - gemmParallel.
+    Структурные ядра - O(n^2), разреженные - O(nnz * n) вместо O(n^3). */
+
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "../common/aligned_matrix.h"
+
+// Вид матрицы
+enum class matrix_kind
+{
+    dense,
+    identity,
+    diagonal,
+    permutation,
+    sparse
+};
+
+const char* kindName(matrix_kind kind);
+
+// Вид матрицы; sparse - если доля ненулевых не больше sparseDensity
+matrix_kind classify(const AlignedMatrix<double>& M, double sparseDensity = 0.05);
+
+// Разреженная матрица в формате CSR
+struct csr_matrix
+{
+    std::size_t rows = 0, cols = 0;
+    std::vector<std::size_t> start;  // Начало строки r в index и values; start[rows] - количество ненулевых
+    std::vector<std::size_t> index;  // Номера столбцов ненулевых элементов
+    std::vector<double> values;      // Значения ненулевых элементов
+};
+
+// CSR матрицы M
+csr_matrix toCsr(const AlignedMatrix<double>& M);
+
+// CSR матрицы M^T (столбцы M - строки результата, строится одним проходом по хранению)
+csr_matrix toCsrTransposed(const AlignedMatrix<double>& M);
+
+// A = B * C, B - разреженная
+void spmm(AlignedMatrix<double>& A, const csr_matrix& B, const AlignedMatrix<double>& C);
+
+// A = B * C, Ct - CSR матрицы C^T
+void spmmTransposed(AlignedMatrix<double>& A, const AlignedMatrix<double>& B, const csr_matrix& Ct);
+
+// A = B * C с выбором ядра по виду B и C
+void multiply(AlignedMatrix<double>& A, const AlignedMatrix<double>& B, const AlignedMatrix<double>& C,
+              double sparseDensity = 0.05);
@@ -0,0 +1,252 @@
+/* Реализация транспонирования.
+    * tile - тайл в регистрах: load (столбцы), transpose, store.
+    * copyBlock / swapBlock - рекурсивное разбиение и листья из тайлов. */
+
+#include "transpose.h"
+#include <immintrin.h>
+#include <algorithm>
+
+namespace
+{
+#ifdef __AVX512F__
+    struct tile
+    {
+        static constexpr std::size_t size = 8;
+        __m512d r[size];
+
+        void load(const double* p, std::size_t ld)
+        {
+            for (std::size_t c = 0; c < size; c++)
+            {
+                r[c] = _mm512_loadu_pd(p + c * ld);
+            }
+        }
+
+        void store(double* p, std::size_t ld) const
+        {
+            for (std::size_t c = 0; c < size; c++)
+            {
+                _mm512_storeu_pd(p + c * ld, r[c]);
+            }
+        }
+
+        // Пары элементов, затем 128-битные четверти в два шага
+        void transpose()
+        {
+            __m512d t[size], s[size];
+            for (std::size_t c = 0; c < size; c += 2)
+            {
+                t[c] = _mm512_unpacklo_pd(r[c], r[c + 1]);
+                t[c + 1] = _mm512_unpackhi_pd(r[c], r[c + 1]);
+            }
+            for (std::size_t h = 0; h < size; h += 4)
+            {
+                s[h] = _mm512_shuffle_f64x2(t[h], t[h + 2], 0x88);
+                s[h + 1] = _mm512_shuffle_f64x2(t[h + 1], t[h + 3], 0x88);
+                s[h + 2] = _mm512_shuffle_f64x2(t[h], t[h + 2], 0xdd);
+                s[h + 3] = _mm512_shuffle_f64x2(t[h + 1], t[h + 3], 0xdd);
+            }
+            for (std::size_t c = 0; c < 4; c++)
+            {
+                r[c] = _mm512_shuffle_f64x2(s[c], s[c + 4], 0x88);
+                r[c + 4] = _mm512_shuffle_f64x2(s[c], s[c + 4], 0xdd);
+            }
+        }
+    };
+#else
+    struct tile
+    {
+        static constexpr std::size_t size = 4;
+        __m256d r[size];
+
+        void load(const double* p, std::size_t ld)
+        {
+            for (std::size_t c = 0; c < size; c++)
+            {
+                r[c] = _mm256_loadu_pd(p + c * ld);
+            }
+        }
+
+        void store(double* p, std::size_t ld) const
+        {
+            for (std::size_t c = 0; c < size; c++)
+            {
+                _mm256_storeu_pd(p + c * ld, r[c]);
+            }
+        }
+
+        void transpose()
+        {
+            const __m256d t0 = _mm256_unpacklo_pd(r[0], r[1]), t1 = _mm256_unpackhi_pd(r[0], r[1]);
+            const __m256d t2 = _mm256_unpacklo_pd(r[2], r[3]), t3 = _mm256_unpackhi_pd(r[2], r[3]);
+            r[0] = _mm256_permute2f128_pd(t0, t2, 0x20);
+            r[1] = _mm256_permute2f128_pd(t1, t3, 0x20);
+            r[2] = _mm256_permute2f128_pd(t0, t2, 0x31);
+            r[3] = _mm256_permute2f128_pd(t1, t3, 0x31);
+        }
+    };
+#endif
+
+    constexpr std::size_t leaf = 32;            // Сторона листа рекурсии
+    constexpr std::size_t task_elements = 1 << 16; // Блоки крупнее делятся на задачи OpenMP
+
+    // Половина стороны, кратная тайлу
+    std::size_t half(std::size_t size)
+    {
+        return std::max(size / 2 / tile::size * tile::size, tile::size);
+    }
+
+    // Лист: dst = src^T тайлами, края поэлементно
+    void copyLeaf(std::size_t rows, std::size_t cols, const double* src, std::size_t lds, double* dst,
+                  std::size_t ldd)
+    {
+        const std::size_t rowsFull = rows / tile::size * tile::size, colsFull = cols / tile::size * tile::size;
+        for (std::size_t j = 0; j < colsFull; j += tile::size)
+        {
+            for (std::size_t i = 0; i < rowsFull; i += tile::size)
+            {
+                tile t;
+                t.load(src + j * lds + i, lds);
+                t.transpose();
+                t.store(dst + i * ldd + j, ldd);
+            }
+        }
+        for (std::size_t j = 0; j < cols; j++) // Нижний край
+        {
+            for (std::size_t i = rowsFull; i < rows; i++)
+            {
+                dst[i * ldd + j] = src[j * lds + i];
+            }
+        }
+        for (std::size_t j = colsFull; j < cols; j++) // Правый край
+        {
+            for (std::size_t i = 0; i < rowsFull; i++)
+            {
+                dst[i * ldd + j] = src[j * lds + i];
+            }
+        }
+    }
+
+    void copyBlock(std::size_t rows, std::size_t cols, const double* src, std::size_t lds, double* dst,
+                   std::size_t ldd)
+    {
+        if (rows <= leaf && cols <= leaf)
+        {
+            copyLeaf(rows, cols, src, lds, dst, ldd);
+            return;
+        }
+
+        const bool spawn = rows * cols > task_elements;
+        if (rows >= cols)
+        {
+            const std::size_t h = half(rows);
+#pragma omp task if (spawn)
+            copyBlock(h, cols, src, lds, dst, ldd);
+            copyBlock(rows - h, cols, src + h, lds, dst + h * ldd, ldd);
+        }
+        else
+        {
+            const std::size_t h = half(cols);
+#pragma omp task if (spawn)
+            copyBlock(rows, h, src, lds, dst, ldd);
+            copyBlock(rows, cols - h, src + h * lds, lds, dst + h, ldd);
+        }
+    }
+
+    // Лист обмена: X (rows x cols) <-> Y^T (Y - cols x rows)
+    void swapLeaf(std::size_t rows, std::size_t cols, double* X, double* Y, std::size_t ld)
+    {
+        const std::size_t rowsFull = rows / tile::size * tile::size, colsFull = cols / tile::size * tile::size;
+        for (std::size_t j = 0; j < colsFull; j += tile::size)
+        {
+            for (std::size_t i = 0; i < rowsFull; i += tile::size)
+            {
+                tile x, y;
+                x.load(X + j * ld + i, ld);
+                y.load(Y + i * ld + j, ld);
+                x.transpose();
+                y.transpose();
+                x.store(Y + i * ld + j, ld);
+                y.store(X + j * ld + i, ld);
+            }
+        }
+        for (std::size_t j = 0; j < cols; j++)
+        {
+            for (std::size_t i = rowsFull; i < rows; i++)
+            {
+                std::swap(X[j * ld + i], Y[i * ld + j]);
+            }
+        }
+        for (std::size_t j = colsFull; j < cols; j++)
+        {
+            for (std::size_t i = 0; i < rowsFull; i++)
+            {
+                std::swap(X[j * ld + i], Y[i * ld + j]);
+            }
+        }
+    }
+
+    void swapBlock(std::size_t rows, std::size_t cols, double* X, double* Y, std::size_t ld)
+    {
+        if (rows <= leaf && cols <= leaf)
+        {
+            swapLeaf(rows, cols, X, Y, ld);
+            return;
+        }
+
+        const bool spawn = rows * cols > task_elements;
+        if (rows >= cols)
+        {
+            const std::size_t h = half(rows);
+#pragma omp task if (spawn)
+            swapBlock(h, cols, X, Y, ld);
+            swapBlock(rows - h, cols, X + h, Y + h * ld, ld);
+        }
+        else
+        {
+            const std::size_t h = half(cols);
+#pragma omp task if (spawn)
+            swapBlock(rows, h, X, Y, ld);
+            swapBlock(rows, cols - h, X + h * ld, Y + h, ld);
+        }
+    }
+
+    // Квадратный блок n x n на месте: диагональные четверти рекурсивно, A12 <-> A21^T
+    void inPlaceBlock(std::size_t n, double* A, std::size_t ld)
+    {
+        if (n <= leaf)
+        {
+            for (std::size_t j = 0; j < n; j++)
+            {
+                for (std::size_t i = j + 1; i < n; i++)
+                {
+                    std::swap(A[j * ld + i], A[i * ld + j]);
+                }
+            }
+            return;
+        }
+
+        const std::size_t h = half(n);
+        const bool spawn = n * n > task_elements;
+#pragma omp task if (spawn)
+        inPlaceBlock(h, A, ld);
+#pragma omp task if (spawn)
+        inPlaceBlock(n - h, A + h * ld + h, ld);
+        swapBlock(h, n - h, A + h * ld, A + h, ld);
+    }
+}
+
+void transpose(std::size_t rows, std::size_t cols, const double* src, std::size_t ldsrc, double* dst,
+               std::size_t lddst)
+{
+#pragma omp parallel
+#pragma omp single
+    copyBlock(rows, cols, src, ldsrc, dst, lddst);
+}
+
+void transposeInPlace(std::size_t n, double* A, std::size_t lda)
+{
+#pragma omp parallel
+#pragma omp single
+    inPlaceBlock(n, A, lda);
+}
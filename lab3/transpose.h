@@ -0,0 +1,28 @@
+/* Транспонирование матриц - основные моменты:
+    Матрицы по столбцам с ведущей размерностью, как в gemm.h:
+    элемент (i, j) матрицы rows x cols лежит в src[j * ldsrc + i].
+
+    Рекурсивное разбиение без параметров кэша (cache-oblivious):
+        блок делится пополам по большей стороне, пока не станет не больше 32 x 32 - такой блок
+        источника и результата помещается в L1 при любом размере кэша и ведущей размерности.
+
+    Лист:
+        * тайлы 8 x 8 (AVX-512) или 4 x 4 (AVX) транспонируются в регистрах: загрузка столбцов,
+          перестановки unpack/shuffle, запись строк - без обращений к памяти по одному элементу;
+        * края, не кратные тайлу, - поэлементно.
+
+    На месте (transposeInPlace) - только квадратные матрицы: диагональные блоки транспонируются
+    рекурсивно, внедиагональные пары меняются местами с транспонированием (тайлы обоих блоков
+    в регистрах). Прямоугольная матрица меняет форму, её транспонирование - через transpose.
+
+    Многопоточность: половины крупных блоков - задачи OpenMP. */
+
+#pragma once
+#include <cstddef>
+
+// dst (cols x rows) = src^T (src - rows x cols); области не пересекаются
+void transpose(std::size_t rows, std::size_t cols, const double* src, std::size_t ldsrc, double* dst,
+               std::size_t lddst);
+
+// A = A^T для квадратной матрицы n x n
+void transposeInPlace(std::size_t n, double* A, std::size_t lda);